@@ -13,6 +13,7 @@
   This file contains numerous functions you must implement. Each function you
   must implement has a
 */
+#include <sstream>
 #include <stdexcept>
 #include "bethyw.h"
 #include "area.h"
@@ -22,16 +23,87 @@
   An alias for the imported JSON parsing library.
 */
 using json = nlohmann::json;
+/*
+  Construct an empty Area whose names and Measures are allocated with a given
+  allocator. Containers of Areas (e.g. in Areas) use this.
+
+  @param alloc
+    The allocator for the names and Measures
+
+  @example
+    std::pmr::monotonic_buffer_resource arena;
+    Area area(Area::allocator_type(&arena));
+*/
+Area::Area(const allocator_type& alloc)
+    : names(alloc), measures(alloc) {}
+
 /*
   Construct an Area with a given local authority code.
 
   @param localAuthorityCode
     The local authority code of the Area
 
+  @param alloc
+    The allocator for the names and Measures (the default memory resource if
+    not given)
+
   @example
     Area("W06000023");
 */
-Area::Area(const std::string& localAuthorityCode): localAuthorityCode(localAuthorityCode) {}
+Area::Area(const std::string& localAuthorityCode, const allocator_type& alloc)
+    : localAuthorityCode(SymbolTable::areas().intern(localAuthorityCode)),
+      names(alloc),
+      measures(alloc) {}
+
+/*
+  Copy an Area, allocating the copy's names and Measures with a given
+  allocator, as Measure's copy does.
+
+  @param other
+    The Area to copy
+
+  @param alloc
+    The allocator for the copy
+
+  @example
+    Area copy(area, Area::allocator_type(&arena));
+*/
+Area::Area(const Area& other, const allocator_type& alloc)
+    : localAuthorityCode(other.localAuthorityCode),
+      names(other.names, alloc),
+      measures(other.measures, alloc) {}
+
+/*
+  Move an Area, allocating the new Area's names and Measures with a given
+  allocator. If the allocators use the same memory resource the memory is
+  taken over, otherwise it is copied.
+
+  @param other
+    The Area to move from
+
+  @param alloc
+    The allocator for the new Area
+
+  @example
+    Area moved(std::move(area), Area::allocator_type(&arena));
+*/
+Area::Area(Area&& other, const allocator_type& alloc)
+    : localAuthorityCode(other.localAuthorityCode),
+      names(std::move(other.names), alloc),
+      measures(std::move(other.measures), alloc) {}
+
+/*
+  Get the allocator the names and Measures are allocated with.
+
+  @return
+    The allocator
+
+  @example
+    auto resource = area.get_allocator().resource();
+*/
+Area::allocator_type Area::get_allocator() const {
+    return measures.get_allocator();
+}
 
 /*
   Retrieve the local authority code for this Area. This function should be 
@@ -46,6 +118,22 @@ Area::Area(const std::string& localAuthorityCode): localAuthorityCode(localAutho
     auto authCode = area.getLocalAuthorityCode();
 */
 std::string Area::getLocalAuthorityCode() const {
+    return SymbolTable::areas().name(this->localAuthorityCode);
+}
+
+/*
+  Retrieve the ID of the local authority code for this Area in
+  SymbolTable::areas(), which is what Areas is keyed by.
+
+  @return
+    The ID of the Area's local authority code
+
+  @example
+    Area area("W06000023");
+    ...
+    auto id = area.getLocalAuthorityID();
+*/
+SymbolID Area::getLocalAuthorityID() const {
     return this->localAuthorityCode;
 }
 
@@ -73,12 +161,11 @@ std::string Area::getLocalAuthorityCode() const {
 */
  std::string Area::getName(const std::string lang) const{
 
-    std::string lower = BethYw::convertToLower(lang);
-
-    if(names.find(lang) == names.end())
+    SymbolID id;
+    if(!SymbolTable::languages().find(lang, id) || names.find(id) == names.end())
         throw (std::out_of_range("No known lang"));
 
-    return names.find(lang)->second;
+    return std::string(names.find(id)->second);
 }
 
 /*
@@ -89,7 +176,8 @@ std::string Area::getLocalAuthorityCode() const {
     e.g. cym or eng, which should be converted to lowercase
 
   @param name
-    The name of the Area in `lang`
+    The name of the Area in `lang`, which replaces any name the Area already
+    has in that language
 
   @throws
     std::invalid_argument if lang is not a three letter alphabetic code
@@ -113,7 +201,8 @@ void Area::setName(std::string lang, std::string name){
             throw std::invalid_argument("Area::setName: Language code must be three alphabetical letters only");
     }
 
-    this->names.insert( std::pair<std::string, std::string>(BethYw::convertToLower(lang),name));
+    SymbolID id = SymbolTable::languages().intern(BethYw::convertToLower(lang));
+    this->names.insert_or_assign(id, name);
 }
 
 /*
@@ -139,11 +228,11 @@ void Area::setName(std::string lang, std::string name){
     auto measure2 = area.getMeasure("pop");
 */
 Measure& Area::getMeasure(const std::string key) {
-
-    if(measures.find(BethYw::convertToLower(key)) == measures.end())
+    SymbolID id;
+    if(!SymbolTable::measures().find(BethYw::convertToLower(key), id) || measures.find(id) == measures.end())
         throw std::out_of_range("No measure found matching " + key);
 
-    return measures.at(key);
+    return measures.at(id);
 }
 
 /*
@@ -177,14 +266,103 @@ Measure& Area::getMeasure(const std::string key) {
 
     area.setMeasure(codename, measure);
 */
-void Area::setMeasure(std::string codename, Measure measure){
-    std::string codenameLower = BethYw::convertToLower(codename);
-    if(this->measures.find(codenameLower) == this->measures.end()) {
-        this->measures.insert(std::pair<std::string, Measure>(codenameLower, measure));
+void Area::setMeasure(std::string codename, const Measure& measure){
+    SymbolID codenameLower = SymbolTable::measures().intern(BethYw::convertToLower(codename));
+
+    auto existing = this->measures.find(codenameLower);
+    if(existing == this->measures.end()) {
+        this->measures.emplace(codenameLower, measure);
+    }else{
+        existing->second.overwrite(measure);
+    }
+}
+
+/*
+  Add a particular Measure to this Area object, as setMeasure() above does, but
+  moving the Measure in rather than copying it if this Area does not have one
+  with the same codename yet.
+
+  @param codename
+    The codename for the Measure
+
+  @param measure
+    The Measure object, which may be moved from
+
+  @example
+    Area area("W06000023");
+    Measure measure("Pop", "Population");
+    measure.setValue(1999, 12345678.9);
+    area.setMeasure("Pop", std::move(measure));
+*/
+void Area::setMeasure(std::string codename, Measure&& measure){
+    SymbolID codenameLower = SymbolTable::measures().intern(BethYw::convertToLower(codename));
+
+    auto existing = this->measures.find(codenameLower);
+    if(existing == this->measures.end()) {
+        this->measures.emplace(codenameLower, std::move(measure));
     }else{
-        measure.merge(measures.at(codenameLower));
-        measures.at(codenameLower) = measure;
+        existing->second.overwrite(measure);
+    }
+}
+
+/*
+  Get the Measure with a given codename, to set its values in place, adding an
+  empty Measure if this Area does not have one yet. As with setMeasure(), the
+  Measure's codename and label are replaced with the ones given. The populate
+  functions of Areas use this to import each reading straight into its
+  Measure, rather than building a Measure to be copied in with setMeasure().
+
+  @param codename
+    The codename for the Measure
+
+  @param label
+    The label for the Measure
+
+  @return
+    The Measure, which stays valid until it is removed from this Area
+
+  @example
+    Area area("W06000023");
+    area.measureFor("Pop", "Population").setValue(1999, 12345678.9);
+*/
+Measure& Area::measureFor(const std::string& codename, const std::string& label){
+    SymbolID codenameLower = SymbolTable::measures().intern(BethYw::convertToLower(codename));
+
+    auto found = this->measures.try_emplace(codenameLower, codename, label);
+    Measure& measure = found.first->second;
+    if(!found.second) {
+        measure.codename = SymbolTable::measures().intern(codename);
+        measure.label = label;
     }
+    return measure;
+}
+
+/*
+  Get a new, empty Measure with a given codename to set the values of in
+  place, replacing any Measure this Area already has with that codename.
+
+  @param codename
+    The codename for the Measure
+
+  @param label
+    The label for the Measure
+
+  @return
+    The Measure, which stays valid until it is removed from this Area
+
+  @example
+    Area area("W06000023");
+    Measure& measure = area.replaceMeasure("Pop", "Population");
+    measure.setValue(1999, 12345678.9);
+*/
+Measure& Area::replaceMeasure(const std::string& codename, const std::string& label){
+    SymbolID codenameLower = SymbolTable::measures().intern(BethYw::convertToLower(codename));
+
+    auto found = this->measures.try_emplace(codenameLower, codename, label);
+    Measure& measure = found.first->second;
+    if(!found.second)
+        measure = Measure(codename, label, this->measures.get_allocator());
+    return measure;
 }
 
 /*
@@ -247,8 +425,8 @@ std::ostream &operator<<(std::ostream &os, const Area &area) {
     if(area.measures.empty())
         os << "<no measures>" << std::endl << std::endl;
 
-    for(auto const& measure : area.measures)
-        os << measure.second;
+    for(auto const* measure : SymbolTable::measures().sorted(area.measures))
+        os << measure->second;
 
     return os;
 }
@@ -275,7 +453,7 @@ std::ostream &operator<<(std::ostream &os, const Area &area) {
     bool eq = area1 == area2;
 */
 bool operator==(const Area& lhs, const Area& rhs){
-    if(lhs.getLocalAuthorityCode() != rhs.getLocalAuthorityCode())
+    if(lhs.localAuthorityCode != rhs.localAuthorityCode)
         return false;
 
     if(lhs.names != rhs.names)
@@ -300,10 +478,82 @@ bool operator==(const Area& lhs, const Area& rhs){
     area1.merge(area2);
  *
  * */
-void Area::merge(Area areaNew){
+void Area::merge(const Area& areaNew){
     measures.insert(areaNew.measures.begin(), areaNew.measures.end());
     names.insert(areaNew.names.begin(), areaNew.names.end());
 }
+
+/*
+ * Combines two areas, as merge() above does, but moving the names and Measures
+ * this Area does not have out of the other Area rather than copying them.
+
+  @param areaNew
+    An Area object, which may be moved from
+
+  @example
+    Area area1("MYCODE1");
+    Area area2("MYCODE1");
+    area1.merge(std::move(area2));
+ */
+void Area::merge(Area&& areaNew){
+    for(auto& measure : areaNew.measures)
+        measures.try_emplace(measure.first, std::move(measure.second));
+    for(auto& name : areaNew.names)
+        names.try_emplace(name.first, std::move(name.second));
+}
+
+/*
+ * Combines another Area into this one in place, with the other Area taking
+ * precedence: its local authority code, names and Measures replace this
+ * Area's, and the names and Measures only this Area has are kept. Measures
+ * are replaced whole, not combined. This is what Areas::setArea() does to an
+ * Area it already has.
+
+  @param areaNew
+    An Area object, which may be moved from
+
+  @example
+    Area area1("MYCODE1");
+    Area area2("MYCODE1");
+    area1.overwrite(std::move(area2));
+ */
+void Area::overwrite(Area&& areaNew){
+    localAuthorityCode = areaNew.localAuthorityCode;
+    for(auto& measure : areaNew.measures)
+        measures.insert_or_assign(measure.first, std::move(measure.second));
+    for(auto& name : areaNew.names)
+        names.insert_or_assign(name.first, std::move(name.second));
+}
+/*
+ * Combines the Measures of another Area into this one, leaving the names of
+ * this Area alone. Each Measure is added with setMeasure(), so where both Areas
+ * have a Measure with the same codename, the readings are combined and the new
+ * Area's readings take precedence.
+
+  @param areaNew
+    An Area object
+
+  @return
+   void
+
+  @example
+    Area area1("MYCODE1");
+    Area area2("MYCODE1");
+    area1.mergeMeasures(area2);
+ */
+void Area::mergeMeasures(const Area& areaNew){
+    //the keys are already lower case IDs, so this is setMeasure() without
+    //interning them again
+    for(auto const& measure : areaNew.measures) {
+        auto existing = measures.find(measure.first);
+        if(existing == measures.end()) {
+            measures.insert(measure);
+        }else{
+            existing->second.overwrite(measure.second);
+        }
+    }
+}
+
 /*
   Convert this Area object, and the Measure instances within those, to a JSON string.
   (https://github.com/nlohmann/json) for more info
@@ -326,15 +576,59 @@ void Area::merge(Area areaNew){
 */
 
 std::string Area::toJSON() const {
-    json j;
+    std::ostringstream os;
+    JSONWriter writer(os);
+    writeJSON(writer);
+    return os.str();
+}
+
+/*
+  Write this Area, and the Measure instances within it, as a JSON object with
+  "measures" and "names" members, or null if it has neither. This is what
+  toJSON() returns, written straight to the JSONWriter instead.
+
+  @param writer
+    The JSONWriter to write to
+
+  @example
+    Area area("W06000023");
+    area.setName("eng", "Powys");
+
+    JSONWriter writer(std::cout);
+    area.writeJSON(writer); // {"names":{"eng":"Powys"}}
+*/
+void Area::writeJSON(JSONWriter& writer) const {
+    if(names.empty() && measures.empty()) {
+        writer.null();
+        return;
+    }
 
-    for (auto const& name : names)
-        j["names"][name.first] = name.second;
+    writer.beginObject();
+
+    //members are written in key order, so measures comes before names
+    if(!measures.empty()) {
+        writer.key("measures");
+        writer.beginObject();
+        const SymbolTable& codes = SymbolTable::measures();
+        for (auto const* measure : codes.sorted(measures)) {
+            writer.key(codes.name(measure->first));
+            measure->second.writeJSON(writer);
+        }
+        writer.endObject();
+    }
 
-    for (auto const& measure : measures)
-        j["measures"][measure.first] = json::parse(measure.second.toJSON());
+    if(!names.empty()) {
+        writer.key("names");
+        writer.beginObject();
+        const SymbolTable& langs = SymbolTable::languages();
+        for (auto const* name : langs.sorted(names)) {
+            writer.key(langs.name(name->first));
+            writer.value(name->second);
+        }
+        writer.endObject();
+    }
 
-    return j.dump();
+    writer.endObject();
 }
 
 
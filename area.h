@@ -14,11 +14,15 @@
   functions and member variables you need to declare in this class.
  */
 
+#include <cstddef>
 #include <string>
 #include <map>
 #include <iostream>
+#include <memory_resource>
 #include <vector>
 #include "measure.h"
+#include "jsonwriter.h"
+#include "symbols.h"
 #include "lib_json.hpp"
 
 /*
@@ -28,40 +32,69 @@
 */
 class Area {
 
+public:
+    //the names and Measures are allocated with this (see Areas)
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
 private:
-    //unique code identifying the area
-    std::string localAuthorityCode;
+    //unique code identifying the area (an ID in SymbolTable::areas())
+    SymbolID localAuthorityCode = 0;
 
-    //key = IOS code for language | Value = name for that area in that language
-    std::map<std::string, std::string> names;
+    //key = IOS code for language (an ID in SymbolTable::languages()) |
+    // Value = name for that area in that language
+    std::pmr::map<SymbolID, std::pmr::string> names;
 
-    //Key = short code representing what data is stored |
-    // Value = Measure object with all reading for that key
-    std::map<std::string, Measure> measures;
+    //Key = short code representing what data is stored (an ID in
+    // SymbolTable::measures()) | Value = Measure object with all reading for that key
+    std::pmr::map<SymbolID, Measure> measures;
 
 public:
     /*----Constructors----*/
     Area() = default;
-    Area(const std::string& localAuthorityCode);
+    explicit Area(const allocator_type& alloc);
+    Area(const std::string& localAuthorityCode, const allocator_type& alloc = {});
+    Area(const Area& other) = default;
+    Area(Area&& other) = default;
+    Area(const Area& other, const allocator_type& alloc);
+    Area(Area&& other, const allocator_type& alloc);
+
+    /*----Assignment----*/
+    Area& operator=(const Area& other) = default;
+    Area& operator=(Area&& other) = default;
 
     /*----Getters----*/
     std::string getLocalAuthorityCode() const;
+    SymbolID getLocalAuthorityID() const;
     std::string getName(const std::string lang) const;
     Measure& getMeasure(const std::string key);
 
     /*----Setters---*/
     void setName(std::string lang, std::string name);
-    void setMeasure(std::string codename, Measure measure);
+    void setMeasure(std::string codename, const Measure& measure);
+    void setMeasure(std::string codename, Measure&& measure);
+    Measure& measureFor(const std::string& codename, const std::string& label);
+    Measure& replaceMeasure(const std::string& codename, const std::string& label);
 
     /*----Miscellaneous---*/
+    allocator_type get_allocator() const;
     unsigned int size() const;
     std::string toJSON() const;
-    void merge(Area areaNew);
+    void writeJSON(JSONWriter& writer) const;
+    void merge(const Area& areaNew);
+    void merge(Area&& areaNew);
+    void overwrite(Area&& areaNew);
+    void mergeMeasures(const Area& areaNew);
 
     /*----Overrides----*/
     friend bool operator==(const Area& lhs, const Area& rhs);
     friend std::ostream& operator<<(std::ostream& os, const Area& area);
 
+    /*----Snapshots read and write the names and measures directly----*/
+    friend class Snapshot;
+
+    /*----A ColumnStore builds the names and measures directly----*/
+    friend class ColumnStore;
+
 
 };
 
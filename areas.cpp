@@ -12,17 +12,24 @@
   various populate() functions) and creating the Area and Measure objects.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
-#include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 
 #include "datasets.h"
 #include "areas.h"
 #include "measure.h"
-#include "datasets.h"
 #include "bethyw.h"
+#include "csv.h"
+#include "numbers.h"
+#include "odata.h"
 #include "lib_json.hpp"
 /*
   An alias for the imported JSON parsing library.
@@ -30,12 +37,514 @@
 using json = nlohmann::json;
 
 /*
-  Constructor for an Areas object.
+  Tests the raw text of a field against a StringFilterSet as it is parsed, so
+  that a std::string does not have to be built for the field of every row.
+  Rows are usually grouped by area and measure, so the answer for the last
+  value is remembered and reused while the value stays the same.
+*/
+class FieldFilter {
+private:
+    //the filter, or nullptr if every value is accepted
+    const StringFilterSet* filter;
+
+    //true if values are lower cased before being looked up (as the
+    //measures filter is)
+    bool lowerCase;
+
+    //the last value tested, and if it was accepted
+    std::string last;
+    bool lastAccepted = false;
+    bool tested = false;
+
+    //buffer for the lower cased value
+    std::string lower;
+
+public:
+    explicit FieldFilter(const StringFilterSet* filter, bool lowerCase = false)
+        : filter(filter == nullptr || filter->empty() ? nullptr : filter), lowerCase(lowerCase) {}
+
+    /*
+      Test a value against the filter.
+
+      @param field
+        The raw text of the field
+
+      @return
+        true if the value is in the filter, or the filter is empty
+    */
+    bool accepts(std::string_view field) {
+        if(filter == nullptr)
+            return true;
+        if(tested && field == last)
+            return lastAccepted;
+
+        last.assign(field.data(), field.size());
+        tested = true;
+        if(lowerCase) {
+            lower.assign(last);
+            for(char& ch : lower)
+                ch = std::tolower(static_cast<unsigned char>(ch));
+            lastAccepted = filter->find(lower) != filter->end();
+        }else{
+            lastAccepted = filter->find(last) != filter->end();
+        }
+        return lastAccepted;
+    }
+};
+
+/*
+  A SourceColumnMapping for a WelshStatsJSON file, resolved once per file so
+  that reading each record does not need to hash column names or catch
+  exceptions. Each column the parser reads is given a fixed slot, and whether
+  the file has a measure code/name in every record, or a single measure for
+  the whole file, is decided up front.
+*/
+struct WelshStatsColumns {
+    //the slots of the fields read from each record
+    enum Slot { AUTH_CODE, AUTH_NAME_ENG, MEASURE_CODE, MEASURE_NAME, YEAR, VALUE, NUM_SLOTS };
+
+    //the JSON key of each slot (empty if the slot is not read from the file)
+    std::string keys[NUM_SLOTS];
+
+    //the slot each field is stored in, as two slots can share a key
+    //(e.g. AQI uses the pollutant name as the measure code and name)
+    int sources[NUM_SLOTS];
+
+    //true if the file has one measure, given by the column mapping
+    bool singleMeasure;
+
+    //the measure of a single measure file
+    std::string singleMeasureCode;
+    std::string singleMeasureName;
+
+    /*
+      Resolve cols into slots.
+
+      @throws
+        std::out_of_range if there are not enough columns in cols
+    */
+    explicit WelshStatsColumns(const BethYw::SourceColumnMapping &cols) {
+        keys[AUTH_CODE] = cols.at(BethYw::SourceColumn::AUTH_CODE);
+        keys[AUTH_NAME_ENG] = cols.at(BethYw::SourceColumn::AUTH_NAME_ENG);
+        keys[YEAR] = cols.at(BethYw::SourceColumn::YEAR);
+        keys[VALUE] = cols.at(BethYw::SourceColumn::VALUE);
+
+        /* Here in case a JSON doesn't have a MEASURE_NAME/MEASURE_CODE
+         * if they don't it will use SINGE_MEASURE_****. */
+        auto code = cols.find(BethYw::SourceColumn::MEASURE_CODE);
+        auto name = cols.find(BethYw::SourceColumn::MEASURE_NAME);
+        singleMeasure = code == cols.end() || name == cols.end();
+        if(singleMeasure) {
+            singleMeasureCode = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_CODE);
+            singleMeasureName = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_NAME);
+        }else{
+            keys[MEASURE_CODE] = code->second;
+            keys[MEASURE_NAME] = name->second;
+        }
+
+        for(int slot = 0; slot < NUM_SLOTS; slot++) {
+            sources[slot] = slot;
+            for(int other = 0; other < slot; other++) {
+                if(!keys[slot].empty() && keys[other] == keys[slot]) {
+                    sources[slot] = other;
+                    break;
+                }
+            }
+        }
+    }
+
+    /*
+      Find the slot for a key in a record. There are only a handful of slots,
+      so comparing against each is quicker than hashing the key.
+
+      @return
+        The slot, or NUM_SLOTS if the key is not read
+    */
+    int slotOf(std::string_view key) const {
+        for(int slot = 0; slot < NUM_SLOTS; slot++) {
+            if(sources[slot] == slot && !keys[slot].empty() && keys[slot] == key)
+                return slot;
+        }
+        return NUM_SLOTS;
+    }
+};
+
+/*
+  The fields of one WelshStatsJSON record, in the slots of a
+  WelshStatsColumns. A field that was missing from the record is null. A
+  slot that shares its key with an earlier one is left empty: read it from
+  fields[sources[slot]].
+*/
+struct WelshStatsRecord {
+    json fields[WelshStatsColumns::NUM_SLOTS];
+
+    //true if the record has already failed the areas filter, and so the
+    //rest of its fields have not been kept
+    bool rejected = false;
+
+    /*
+      Empty every slot, ready for the next record.
+    */
+    void clear() {
+        for(auto& field : fields)
+            field = nullptr;
+        rejected = false;
+    }
+};
+
+/*
+  A SAX handler for json::sax_parse() that streams the records of the "value"
+  array in a WelshStatsJSON file. Each record is collected into a
+  WelshStatsRecord holding only the fields in the column plan, and is handed
+  to a callback as soon as its closing brace has been read. Nothing else in
+  the file is kept, so memory use is proportional to a single record rather
+  than the whole file.
+
+  The JSON is expected to look like: { ..., "value": [ { record }, ... ] }
+*/
+class WelshStatsSax {
+private:
+    //nesting depth of the objects inside the "value" array
+    static const unsigned int RECORD_DEPTH = 3;
+
+    //the slots of the fields to keep from each record
+    const WelshStatsColumns& plan;
+
+    //the areas filter, tested as soon as a record's authority code is read
+    FieldFilter& areasFilter;
+
+    //called with each complete record
+    std::function<void(WelshStatsRecord&)> onRecord;
+
+    //number of objects/arrays we are currently inside
+    unsigned int depth = 0;
+
+    //true when the last top level key read was "value"
+    bool valueKey = false;
+
+    //true while inside the top level "value" array
+    bool inValues = false;
+
+    //the record currently being read
+    WelshStatsRecord record;
+
+    //the slot of the current field, or NUM_SLOTS if it is not kept
+    int slot = WelshStatsColumns::NUM_SLOTS;
+
+    /*
+      Handle a complete value (a scalar, or a container we do not look in).
+    */
+    bool value(json&& value) {
+        if(inValues && depth == RECORD_DEPTH && slot != WelshStatsColumns::NUM_SLOTS) {
+            if(record.rejected)
+                return true;
+            if(slot == WelshStatsColumns::AUTH_CODE && value.is_string()
+               && !areasFilter.accepts(value.get_ref<const std::string&>())) {
+                record.rejected = true;
+                return true;
+            }
+            record.fields[slot] = std::move(value);
+        }else if(inValues && depth == RECORD_DEPTH - 1) {
+            //not an object, so it has none of the fields; let the record
+            //parser decide what to do
+            record.clear();
+            onRecord(record);
+        }
+        return true;
+    }
+
+public:
+    WelshStatsSax(const WelshStatsColumns &plan,
+                  FieldFilter &areasFilter,
+                  std::function<void(WelshStatsRecord&)> onRecord)
+        : plan(plan), areasFilter(areasFilter), onRecord(onRecord) {}
+
+    bool null() { return value(nullptr); }
+    bool boolean(bool val) { return value(val); }
+    bool number_integer(json::number_integer_t val) { return value(val); }
+    bool number_unsigned(json::number_unsigned_t val) { return value(val); }
+    bool number_float(json::number_float_t val, const json::string_t&) { return value(val); }
+    bool string(json::string_t& val) { return value(std::move(val)); }
+    bool binary(json::binary_t&) { return value(nullptr); }
+
+    bool key(json::string_t& key) {
+        if(depth == 1)
+            valueKey = key == "value";
+        if(inValues && depth == RECORD_DEPTH)
+            slot = plan.slotOf(key);
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        if(inValues && depth == RECORD_DEPTH - 1)
+            record.clear();
+        else if(inValues && depth == RECORD_DEPTH)
+            value(nullptr);
+        depth++;
+        return true;
+    }
+
+    bool end_object() {
+        depth--;
+        if(inValues && depth == RECORD_DEPTH - 1)
+            onRecord(record);
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if(depth == 1 && valueKey)
+            inValues = true;
+        else if(inValues && depth >= RECORD_DEPTH - 1)
+            value(nullptr);
+        depth++;
+        return true;
+    }
+
+    bool end_array() {
+        depth--;
+        if(inValues && depth == 1)
+            inValues = false;
+        return true;
+    }
+
+    template<class Exception>
+    bool parse_error(std::size_t, const std::string&, const Exception& ex) {
+        throw ex;
+    }
+};
+
+/*
+  Constructor for an Areas object. The Area and Measure objects are allocated
+  from the default memory resource (normally the heap).
+
+  @example
+    Areas data = Areas();
+*/
+Areas::Areas() : Areas(std::pmr::get_default_resource()) {}
+
+/*
+  Constructor for an Areas object whose Area and Measure objects (and their
+  names, labels and readings) are all allocated from a given memory resource.
+  With an arena, such as std::pmr::monotonic_buffer_resource, the whole object
+  graph is allocated from a few large blocks, and freeing an Area or Measure
+  costs nothing; the blocks are freed at once when the arena is destroyed.
+
+  Area and Measure objects added from elsewhere (e.g. with setArea() or
+  merge()) are copied into the resource. The resource must outlive the Areas.
+
+  @param resource
+    The memory resource to allocate from
+
+  @example
+    std::pmr::monotonic_buffer_resource arena;
+    Areas data(&arena);
+*/
+Areas::Areas(std::pmr::memory_resource* resource)
+    : areas(resource), jsonMode(WelshStatsJSONMode::Streaming), storage(AreasStorage::Objects) {}
+
+/*
+  Move constructor, which takes over the Area objects, the ColumnStore and
+  the settings of another Areas object. Only the mutex is not moved; the new
+  object has its own.
+
+  @param other
+    The Areas object to move from
+
+  @example
+    std::vector<Areas> shards;
+    shards.emplace_back(&arena);
+*/
+Areas::Areas(Areas&& other)
+    : areas(std::move(other.areas)),
+      jsonMode(other.jsonMode),
+      storage(other.storage),
+      threads(other.threads),
+      columns(std::move(other.columns)),
+      rowsApplied(other.rowsApplied),
+      areasApplied(other.areasApplied),
+      columnsChanged(other.columnsChanged),
+      stats(other.stats) {}
+
+/*
+  Move assignment, which takes over everything but the mutex, as the move
+  constructor does.
+
+  @param other
+    The Areas object to move from
+
+  @return
+    This Areas object
+
+  @example
+    Areas data;
+    data = std::move(loaded);
+*/
+Areas& Areas::operator=(Areas&& other) {
+    areas = std::move(other.areas);
+    jsonMode = other.jsonMode;
+    storage = other.storage;
+    threads = other.threads;
+    columns = std::move(other.columns);
+    rowsApplied = other.rowsApplied;
+    areasApplied = other.areasApplied;
+    columnsChanged = other.columnsChanged;
+    stats = other.stats;
+    return *this;
+}
+
+/*
+  Get the memory resource the Area and Measure objects are allocated from.
+
+  @return
+    The memory resource
+
+  @example
+    Areas loaded(data.getResource());
+*/
+std::pmr::memory_resource* Areas::getResource() const {
+    return areas.get_allocator().resource();
+}
+
+/*
+  Choose how WelshStatsJSON files are parsed by populateFromWelshStatsJSON().
+  Streaming (the default) handles each record as soon as it has been read,
+  Document parses the whole file into memory first, and Scanner reads the
+  records with an ODataScanner (see scanWelshStatsJSON()). All three give
+  the same data.
+
+  @param mode
+    The WelshStatsJSONMode to use
+
+  @example
+    Areas data = Areas();
+    data.setJSONMode(WelshStatsJSONMode::Document);
+*/
+void Areas::setJSONMode(WelshStatsJSONMode mode) {
+    jsonMode = mode;
+}
+
+/*
+  Get how WelshStatsJSON files are parsed by populateFromWelshStatsJSON().
+
+  @return
+    The WelshStatsJSONMode in use
+
+  @example
+    Areas shard = Areas();
+    shard.setJSONMode(data.getJSONMode());
+*/
+WelshStatsJSONMode Areas::getJSONMode() const {
+    return jsonMode;
+}
+
+/*
+  Choose where the populate() functions put the data they import. Objects
+  (the default) builds Area and Measure objects as each row is read. Columns
+  appends each reading to a ColumnStore (see getColumns()), and the Area and
+  Measure objects are only built, from the rows, when a function that needs
+  them (e.g. getArea(), toJSON()) is called. Both give the same objects.
+
+  With Columns storage, changes made to the objects afterwards (e.g. with
+  setArea()) are not added to the ColumnStore. The storage should be chosen
+  before anything is imported.
+
+  @param storage
+    The AreasStorage to use
+
+  @example
+    Areas data = Areas();
+    data.setStorage(AreasStorage::Columns);
+*/
+void Areas::setStorage(AreasStorage storage) {
+    this->storage = storage;
+}
+
+/*
+  Get where the populate() functions put the data they import.
+
+  @return
+    The AreasStorage in use
+
+  @example
+    Areas shard = Areas();
+    shard.setStorage(data.getStorage());
+*/
+AreasStorage Areas::getStorage() const {
+    return storage;
+}
+
+/*
+  Choose how many threads the populate() functions may use to parse a single
+  file. A WelshStatsJSON file read with WelshStatsJSONMode::Scanner is split
+  into ranges of records, each parsed into its own shard on a thread of its
+  own, and the shards are merged in order, which gives the same data as
+  parsing it on one thread. AuthorityCodeCSV and AuthorityByYearCSV files
+  are split into ranges of rows in the same way, each parsed into its own
+  ColumnStore batch, and the batches are committed in order. Other files are
+  parsed on one thread.
+
+  @param threads
+    The number of threads (0 is taken as 1)
 
   @example
     Areas data = Areas();
+    data.setJSONMode(WelshStatsJSONMode::Scanner);
+    data.setThreads(std::thread::hardware_concurrency());
 */
-Areas::Areas() {}
+void Areas::setThreads(unsigned int threads) {
+    this->threads = std::max(threads, 1u);
+}
+
+/*
+  Get how many threads the populate() functions may use to parse a single
+  file.
+
+  @return
+    The number of threads
+
+  @example
+    auto threads = data.getThreads();
+*/
+unsigned int Areas::getThreads() const {
+    return threads;
+}
+
+/*
+  Get the rows imported with Columns storage, for scanning. With Objects
+  storage the ColumnStore is empty.
+
+  @return
+    The ColumnStore
+
+  @example
+    const ColumnStore& columns = data.getColumns();
+    double total = 0;
+    for(std::size_t row = 0; row < columns.size(); row++)
+      total += columns.values()[row];
+*/
+const ColumnStore& Areas::getColumns() const {
+    return columns;
+}
+
+/*
+  Bring the Area and Measure objects up to date with any areas and rows
+  imported into the ColumnStore since this was last called. Called by every
+  function that reads or changes the objects. Does nothing with Objects
+  storage, or if nothing has been imported since.
+
+  Const functions call this too, so it holds a mutex: two threads reading
+  the same Areas object build the objects once, one after the other.
+*/
+void Areas::materialise() const {
+    std::lock_guard<std::mutex> lock(materialising);
+    if(!columnsChanged)
+        return;
+
+    columns.applyTo(areas, rowsApplied, areasApplied);
+    rowsApplied = columns.size();
+    areasApplied = columns.areaCount();
+    columnsChanged = false;
+}
 
 /*
   Add a particular Area to the Areas object.
@@ -60,17 +569,82 @@ Areas::Areas() {}
     Area area(localAuthorityCode);
     data.setArea(localAuthorityCode, area);
 */
-void Areas::setArea(std::string localAuthorityCode, Area area) {
+void Areas::setArea(std::string localAuthorityCode, const Area& area) {
+    setArea(std::move(localAuthorityCode), Area(area, areas.get_allocator()));
+}
 
-    if(areas.find(localAuthorityCode) == areas.end()){
-        areas.insert(std::pair<std::string, Area>(localAuthorityCode, area));
+/*
+  Add a particular Area to the Areas object, as setArea() above does, but
+  moving the Area's names and Measures in rather than copying them. They are
+  only copied if the Area was allocated from a different memory resource.
 
+  @param localAuthorityCode
+    The local authority code of the Area
+
+  @param area
+    The Area object, which may be moved from
+
+  @example
+    Areas data = Areas();
+    Area area("W06000023");
+    area.setName("eng", "Powys");
+    data.setArea("W06000023", std::move(area));
+*/
+void Areas::setArea(std::string localAuthorityCode, Area&& area) {
+    materialise();
+    SymbolID id = SymbolTable::areas().intern(localAuthorityCode);
+    auto existing = areas.find(id);
+    if(existing == areas.end()){
+        areas.emplace(id, std::move(area));
     }else{
-        area.merge(areas.at(localAuthorityCode));
-        areas.at(localAuthorityCode) = area;
+        existing->second.overwrite(std::move(area));
     }
 }
 
+/*
+  Get the Area with a given local authority code, to import names and
+  Measures into in place, adding an empty Area if there isn't one yet. The
+  populate functions use this (with Area::measureFor()), so that no Area or
+  Measure is built and then copied in while importing.
+
+  @param localAuthorityCode
+    The local authority code of the Area
+
+  @return
+    The Area, which stays valid until it is removed from this Areas instance
+
+  @example
+    Areas data = Areas();
+    Area& area = data.emplaceArea("W06000023");
+    area.setName("eng", "Powys");
+    area.measureFor("Pop", "Population").setValue(1999, 12345678.9);
+*/
+Area& Areas::emplaceArea(const std::string& localAuthorityCode) {
+    return emplaceArea(SymbolTable::areas().intern(localAuthorityCode));
+}
+
+/*
+  Get the Area with a given local authority code, as emplaceArea() above
+  does, by the ID of the code in SymbolTable::areas().
+
+  @param localAuthorityID
+    The ID of the local authority code of the Area
+
+  @return
+    The Area, which stays valid until it is removed from this Areas instance
+
+  @example
+    SymbolID id = SymbolTable::areas().intern("W06000023");
+    Area& area = data.emplaceArea(id);
+*/
+Area& Areas::emplaceArea(SymbolID localAuthorityID) {
+    materialise();
+    auto found = areas.find(localAuthorityID);
+    if(found == areas.end())
+        found = areas.try_emplace(localAuthorityID, SymbolTable::areas().name(localAuthorityID)).first;
+    return found->second;
+}
+
 /*
   Retrieve an Area instance with a given local authority code.
 
@@ -93,10 +667,69 @@ void Areas::setArea(std::string localAuthorityCode, Area area) {
     Area area2 = areas.getArea("W06000023");
 */
 Area& Areas::getArea(std::string localAuthorityCode){
-    if(areas.find(localAuthorityCode) == areas.end())
+    materialise();
+    SymbolID id;
+    auto found = areas.end();
+    if(!SymbolTable::areas().find(localAuthorityCode, id) || (found = areas.find(id)) == areas.end())
         throw std::out_of_range("No area found matching " + localAuthorityCode);
 
-    return areas.at(localAuthorityCode);
+    return found->second;
+}
+
+/*
+  Retrieve the counts of rows read and accepted by the filters, for all of
+  the data imported into this Areas instance so far.
+
+  @return
+    The ImportStats for this Areas instance
+
+  @example
+    Areas data = Areas();
+    data.populate(...);
+    auto rows = data.getImportStats().rows;
+*/
+const ImportStats& Areas::getImportStats() const{
+    return stats;
+}
+
+/*
+  Add the counts from another ImportStats to these ones.
+
+  @param other
+    The counts to add
+
+  @return
+    These counts
+*/
+ImportStats& ImportStats::operator+=(const ImportStats& other){
+    rows += other.rows;
+    areasAccepted += other.areasAccepted;
+    measuresAccepted += other.measuresAccepted;
+    readingsAccepted += other.readingsAccepted;
+    return *this;
+}
+
+/*
+  Find how much each count has grown since an earlier copy of these counts.
+
+  @param other
+    The earlier counts
+
+  @return
+    The difference between the counts
+
+  @example
+    ImportStats before = areas.getImportStats();
+    areas.populate(...);
+    ImportStats added = areas.getImportStats() - before;
+*/
+ImportStats ImportStats::operator-(const ImportStats& other) const{
+    ImportStats difference;
+    difference.rows = rows - other.rows;
+    difference.areasAccepted = areasAccepted - other.areasAccepted;
+    difference.measuresAccepted = measuresAccepted - other.measuresAccepted;
+    difference.readingsAccepted = readingsAccepted - other.readingsAccepted;
+    return difference;
 }
 
 /*
@@ -116,6 +749,7 @@ Area& Areas::getArea(std::string localAuthorityCode){
     auto size = areas.size(); // returns 1
 */
 unsigned int Areas::size() const{
+    materialise();
     return areas.size();
 }
 
@@ -129,6 +763,9 @@ unsigned int Areas::size() const{
   the first row gives the name of the columns, and then each row is a set of
   data.
 
+  The stream is read into memory and then split with a CSVTokenizer, so
+  quoted fields (RFC 4180) are supported.
+
   @param is
     The input stream from InputSource
 
@@ -172,134 +809,564 @@ void Areas::populateFromAuthorityCodeCSV(
     if(cols.size() < 3)
         throw std::out_of_range("Not enough columns");
 
-    if(!(is.good()))
-        throw (std::runtime_error("Failed to open file"));
+    if(!(is.good()))
+        throw (std::runtime_error("Failed to open file"));
+
+    std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    populateFromAuthorityCodeCSV(std::string_view(contents), cols, areasFilter);
+}
+
+/*
+    Takes json dir and populated the area contaoner with that data which matches the filer.
+    if a filter is missing or emtpy (<0,0> for yearsfiler) all data is imporated
+
+    By default the file is streamed, so only one record of the "value" array is
+    held in memory at a time. See setJSONMode() to parse the whole document
+    first instead.
+
+  @param is
+    The input stream from InputSource
+
+  @param cols
+    A map of the enum BethyYw::SourceColumnMapping (see datasets.h) to strings
+    that give the column header in the CSV file
+
+  @param areasFilter
+    An umodifiable pointer to set of umodifiable strings of areas to import,
+    or an empty set if all areas should be imported
+
+  @param measuresFilter
+    An umodifiable pointer to set of umodifiable strings of measures to import,
+    or an empty set if all measures should be imported
+
+  @param yearsFilter
+    An umodifiable pointer to an umodifiable tuple of two unsigned integers,
+    where if both values are 0, then all years should be imported, otherwise
+    they should be treated as the range of years to be imported (inclusively)
+
+  @return
+    void
+
+  @throws 
+    std::runtime_error if a parsing error occurs (e.g. due to a malformed file)
+    std::out_of_range if there are not enough columns in cols
+
+  @see
+    See datasets.h for details of how the variable cols is organised
+
+  @see
+    See bethyw.cpp for details of how the variable areasFilter is created
+
+  @example
+    InputFile input("data/popu1009.json");
+    auto is = input.open();
+
+    auto cols = InputFiles::DATASETS["popden"].COLS;
+
+    auto areasFilter = BethYw::parseAreasArg();
+    auto measuresFilter = BethYw::parseMeasuresArg();
+    auto yearsFilter = BethYw::parseMeasuresArg();
+
+    Areas data = Areas();
+    areas.populateFromWelshStatsJSON(
+      is,
+      cols,
+      &areasFilter,
+      &measuresFilter,
+      &yearsFilter);
+*/
+void Areas::populateFromWelshStatsJSON(std::istream &is,
+            const BethYw::SourceColumnMapping &cols,
+            const StringFilterSet * const areasFilter,
+            const StringFilterSet * const measuresFilter,
+            const YearFilterTuple * const yearsFilter){
+    WelshStatsColumns plan(cols);
+    FieldFilter areaCodes(areasFilter);
+    FieldFilter measureCodes(measuresFilter, true);
+
+    if(jsonMode == WelshStatsJSONMode::Document) {
+        json j;
+        is >> j;
+        importWelshStatsJSON(j, plan, areaCodes, measureCodes, yearsFilter);
+        return;
+    }
+
+    if(jsonMode == WelshStatsJSONMode::Scanner) {
+        std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        scanWelshStatsJSON(contents, false, plan, areaCodes, measureCodes, yearsFilter);
+        return;
+    }
+
+    WelshStatsSax sax(plan, areaCodes, [&](WelshStatsRecord& record) {
+        importWelshStatsRecord(record, plan, areaCodes, measureCodes, yearsFilter);
+    });
+    //not strict, to match operator>> which ignores anything after the document
+    json::sax_parse(is, &sax, json::input_format_t::json, false);
+}
+
+/*
+  The same as populateFromWelshStatsJSON() above, but parses the JSON straight
+  from a block of memory (e.g. a MappedInputFile) rather than through a stream.
+
+  @param buffer
+    A view of the whole JSON file
+
+  @param cols
+    A map of the enum BethyYw::SourceColumnMapping (see datasets.h) to strings
+    that give the column header in the CSV file
+
+  @param areasFilter
+    An umodifiable pointer to set of umodifiable strings of areas to import,
+    or an empty set if all areas should be imported
+
+  @param measuresFilter
+    An umodifiable pointer to set of umodifiable strings of measures to import,
+    or an empty set if all measures should be imported
+
+  @param yearsFilter
+    An umodifiable pointer to an umodifiable tuple of two unsigned integers,
+    where if both values are 0, then all years should be imported, otherwise
+    they should be treated as the range of years to be imported (inclusively)
+
+  @return
+    void
+
+  @throws
+    std::runtime_error if a parsing error occurs (e.g. due to a malformed file)
+    std::out_of_range if there are not enough columns in cols
+
+  @example
+    MappedInputFile input("data/popu1009.json");
+    auto cols = InputFiles::DATASETS["popden"].COLS;
+
+    Areas data = Areas();
+    areas.populateFromWelshStatsJSON(
+      input.open(),
+      cols,
+      &areasFilter,
+      &measuresFilter,
+      &yearsFilter);
+*/
+void Areas::populateFromWelshStatsJSON(std::string_view buffer,
+            const BethYw::SourceColumnMapping &cols,
+            const StringFilterSet * const areasFilter,
+            const StringFilterSet * const measuresFilter,
+            const YearFilterTuple * const yearsFilter){
+    WelshStatsColumns plan(cols);
+    FieldFilter areaCodes(areasFilter);
+    FieldFilter measureCodes(measuresFilter, true);
+
+    if(jsonMode == WelshStatsJSONMode::Document) {
+        json j = json::parse(buffer.begin(), buffer.end());
+        importWelshStatsJSON(j, plan, areaCodes, measureCodes, yearsFilter);
+        return;
+    }
+
+    if(jsonMode == WelshStatsJSONMode::Scanner) {
+        scanWelshStatsJSON(buffer, true, plan, areaCodes, measureCodes, yearsFilter);
+        return;
+    }
+
+    WelshStatsSax sax(plan, areaCodes, [&](WelshStatsRecord& record) {
+        importWelshStatsRecord(record, plan, areaCodes, measureCodes, yearsFilter);
+    });
+    json::sax_parse(buffer.begin(), buffer.end(), &sax);
+}
+
+//the smallest range of a file worth parsing on a thread of its own
+static const std::size_t MIN_RANGE_BYTES = 1 << 20;
+
+/*
+  Run a task for each of a number of ranges of a file, on a pool of threads
+  that take the next range until there are none left.
+
+  @param ranges
+    The number of ranges
+
+  @param threads
+    The most threads to run at once
+
+  @param task
+    Called with the index of each range, from any thread
+
+  @return
+    true if every task returned, false if any threw an exception
+
+  @example
+    bool imported = importRanges(bounds.size() - 1, threads, [&](std::size_t i) {
+      ...
+    });
+*/
+template<class Task>
+static bool importRanges(std::size_t ranges, unsigned int threads, Task task) {
+    //a char per range rather than vector<bool>, whose elements share words
+    //and so cannot be written from different threads at once
+    std::vector<char> failed(ranges, false);
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]() {
+        for(std::size_t i = next++; i < ranges; i = next++) {
+            try{
+                task(i);
+            }catch(...) {
+                failed[i] = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(std::size_t i = 0; i < threads && i < ranges; i++)
+        pool.emplace_back(worker);
+    for(auto& thread : pool)
+        thread.join();
+
+    return std::find(failed.begin(), failed.end(), char(true)) == failed.end();
+}
+
+/*
+  Read the records of a WelshStatsJSON file with an ODataScanner and add
+  every record that matches the filters (see importScannedRecords()). With
+  more than one thread (see setThreads()), a file of at least two ranges of
+  MIN_RANGE_BYTES is imported in parallel.
+
+  If the scanner finds anything it cannot read, the file is parsed again
+  with the SAX parser, passing over the records that have already been
+  imported, so the result (including any parse error) is the same as
+  Streaming mode.
+
+  @param buffer
+    The whole JSON file
+
+  @param strict
+    If true, only whitespace may follow the JSON document (as with a
+    buffer), otherwise anything after it is ignored (as with a stream)
+
+  @param plan
+    The columns of the file, resolved from its SourceColumnMapping
+
+  @param areasFilter
+    The areas to import
+
+  @param measuresFilter
+    The measures to import, tested in lower case
+
+  @see
+    populateFromWelshStatsJSON() for the other parameters
+*/
+void Areas::scanWelshStatsJSON(std::string_view buffer,
+            bool strict,
+            const WelshStatsColumns &plan,
+            FieldFilter &areasFilter,
+            FieldFilter &measuresFilter,
+            const YearFilterTuple * const yearsFilter){
+    if(threads > 1 && buffer.size() >= 2 * MIN_RANGE_BYTES
+       && scanWelshStatsJSONInParallel(buffer, strict, plan, areasFilter, measuresFilter, yearsFilter))
+        return;
+
+    std::size_t imported = 0;
+    try {
+        ODataScanner scanner(buffer, strict);
+        importScannedRecords(scanner, plan, areasFilter, measuresFilter, yearsFilter, imported);
+    } catch(const ODataScanner::Unexpected&) {
+        std::size_t skipped = 0;
+        WelshStatsSax sax(plan, areasFilter, [&](WelshStatsRecord& record) {
+            if(skipped < imported)
+                skipped++;
+            else
+                importWelshStatsRecord(record, plan, areasFilter, measuresFilter, yearsFilter);
+        });
+        json::sax_parse(buffer.begin(), buffer.end(), &sax, json::input_format_t::json, strict);
+    }
+}
+
+/*
+  Split the "value" array of a WelshStatsJSON file into ranges of records
+  (see ODataScanner::splitRecords()), import each range into its own shard
+  on a pool of threads, and merge the shards in order, as loadDatasets()
+  does for whole datasets. Each shard allocates from its own arena.
+
+  Nothing is added to this Areas unless every range was imported, so if
+  anything goes wrong (a range the scanner cannot read, or an error in the
+  data) the file can be imported again on one thread, which gives the same
+  result (including the same exception) as if this had not been tried.
+
+  @param buffer
+    The whole JSON file
+
+  @param strict
+    If true, only whitespace may follow the JSON document
+
+  @param plan
+    The columns of the file, resolved from its SourceColumnMapping
+
+  @param areasFilter
+    The areas to import, copied for each thread
+
+  @param measuresFilter
+    The measures to import, copied for each thread
+
+  @return
+    true if the file was imported, false if it should be imported on one
+    thread instead
+
+  @see
+    populateFromWelshStatsJSON() for the other parameters
+*/
+bool Areas::scanWelshStatsJSONInParallel(std::string_view buffer,
+            bool strict,
+            const WelshStatsColumns &plan,
+            const FieldFilter &areasFilter,
+            const FieldFilter &measuresFilter,
+            const YearFilterTuple * const yearsFilter){
+    std::vector<std::size_t> splits;
+    try {
+        std::size_t parts = std::min<std::size_t>(threads, buffer.size() / MIN_RANGE_BYTES);
+        splits = ODataScanner::splitRecords(buffer, parts);
+    } catch(const ODataScanner::Unexpected&) {
+        return false;
+    }
+    if(splits.empty())
+        return false;
+
+    //range i is from bounds[i] up to bounds[i + 1]
+    std::vector<std::size_t> bounds = {0};
+    bounds.insert(bounds.end(), splits.begin(), splits.end());
+    bounds.push_back(std::string_view::npos);
+    const std::size_t ranges = bounds.size() - 1;
+
+    std::vector<std::pmr::monotonic_buffer_resource> arenas(ranges);
+    std::vector<Areas> shards;
+    shards.reserve(ranges);
+    for(auto& arena : arenas) {
+        shards.emplace_back(&arena);
+        shards.back().setStorage(storage);
+    }
+    bool imported = importRanges(ranges, threads, [&](std::size_t i) {
+        FieldFilter areaCodes = areasFilter;
+        FieldFilter measureCodes = measuresFilter;
+        ODataScanner scanner(buffer, strict);
+        scanner.setRange(bounds[i], bounds[i + 1]);
+        std::size_t records = 0;
+        shards[i].importScannedRecords(scanner, plan, areaCodes, measureCodes, yearsFilter, records);
+    });
+    if(!imported)
+        return false;
+
+    for(auto& shard : shards)
+        merge(std::move(shard), BethYw::WelshStatsJSON);
+    return true;
+}
+
+/*
+  Import the records an ODataScanner reads, as the SAX parser would: only
+  the fields in the column plan are converted into json values (reusing the
+  strings of the last record), and once a record has failed the areas filter
+  the rest of it is skipped.
+
+  @param scanner
+    The scanner to read records from
+
+  @param plan
+    The columns of the file, resolved from its SourceColumnMapping
+
+  @param areasFilter
+    The areas to import
+
+  @param measuresFilter
+    The measures to import, tested in lower case
+
+  @param imported
+    Incremented for each record imported, so that if the scanner throws
+    ODataScanner::Unexpected, it is known how many records were imported
+
+  @throws
+    ODataScanner::Unexpected if the scanner cannot read the records
+
+  @see
+    populateFromWelshStatsJSON() for the other parameters
+*/
+void Areas::importScannedRecords(ODataScanner& scanner,
+            const WelshStatsColumns &plan,
+            FieldFilter &areasFilter,
+            FieldFilter &measuresFilter,
+            const YearFilterTuple * const yearsFilter,
+            std::size_t& imported){
+    WelshStatsRecord record;
+    std::string_view key;
+    while(scanner.nextRecord()) {
+        bool found[WelshStatsColumns::NUM_SLOTS] = {};
+        record.rejected = false;
+
+        while(scanner.nextKey(key)) {
+            int slot = plan.slotOf(key);
+            if(slot == WelshStatsColumns::NUM_SLOTS || record.rejected) {
+                scanner.skipValue();
+                continue;
+            }
 
-    //reading first line which is just the name of cols
-    //As coursework states that this should remain constant, throw away the line
-    std::string line;
-    std::getline(is,line);
-
-    while (std::getline(is, line)) {
-        std::string code = getVariableCSV(line);
-        if(isFilterEmpty(areasFilter) || areasFilter->find(code) != areasFilter->end()){
-            Area temp(code);
-            temp.setName("eng", getVariableCSV(line));
-            temp.setName("cym", getVariableCSV(line));
-            this->setArea(code, temp);
+            json& field = record.fields[slot];
+            scanner.readValue(field);
+            found[slot] = true;
+            if(slot == WelshStatsColumns::AUTH_CODE && field.is_string()
+               && !areasFilter.accepts(field.get_ref<const std::string&>()))
+                record.rejected = true;
+        }
+
+        //a field missing from this record is null, as with the SAX parser
+        for(int slot = 0; slot < WelshStatsColumns::NUM_SLOTS; slot++) {
+            if(!found[slot])
+                record.fields[slot] = nullptr;
         }
+
+        importWelshStatsRecord(record, plan, areasFilter, measuresFilter, yearsFilter);
+        imported++;
     }
 }
 
 /*
-    Takes json dir and populated the area contaoner with that data which matches the filer.
-    if a filter is missing or emtpy (<0,0> for yearsfiler) all data is imporated
+  Walk the "value" array of an already parsed WelshStatsJSON document and add
+  every record that matches the filters. Shared by both of the
+  populateFromWelshStatsJSON() functions.
 
-  @param is
-    The input stream from InputSource
+  @param j
+    The parsed JSON document
 
-  @param cols
-    A map of the enum BethyYw::SourceColumnMapping (see datasets.h) to strings
-    that give the column header in the CSV file
+  @param plan
+    The columns of the file, resolved from its SourceColumnMapping
 
   @param areasFilter
-    An umodifiable pointer to set of umodifiable strings of areas to import,
-    or an empty set if all areas should be imported
+    The areas to import
 
   @param measuresFilter
-    An umodifiable pointer to set of umodifiable strings of measures to import,
-    or an empty set if all measures should be imported
-
-  @param yearsFilter
-    An umodifiable pointer to an umodifiable tuple of two unsigned integers,
-    where if both values are 0, then all years should be imported, otherwise
-    they should be treated as the range of years to be imported (inclusively)
+    The measures to import, tested in lower case
 
-  @return
-    void
+  @see
+    populateFromWelshStatsJSON() for the other parameters
+*/
+void Areas::importWelshStatsJSON(json& j,
+            const WelshStatsColumns &plan,
+            FieldFilter &areasFilter,
+            FieldFilter &measuresFilter,
+            const YearFilterTuple * const yearsFilter){
+    WelshStatsRecord record;
+    for (auto& el : j["value"].items()) {
+        record.clear();
+        if(el.value().is_object()) {
+            for(auto& field : el.value().items()) {
+                int slot = plan.slotOf(field.key());
+                if(slot != WelshStatsColumns::NUM_SLOTS)
+                    record.fields[slot] = std::move(field.value());
+            }
+        }
+        importWelshStatsRecord(record, plan, areasFilter, measuresFilter, yearsFilter);
+    }
+}
 
-  @throws 
-    std::runtime_error if a parsing error occurs (e.g. due to a malformed file)
-    std::out_of_range if there are not enough columns in cols
+/*
+  Add a single record (one element of the "value" array) of a WelshStatsJSON
+  file, if it matches the filters.
 
-  @see
-    See datasets.h for details of how the variable cols is organised
+  @param data
+    The fields of one record
 
-  @see
-    See bethyw.cpp for details of how the variable areasFilter is created
+  @param plan
+    The columns of the file, resolved from its SourceColumnMapping
 
-  @example
-    InputFile input("data/popu1009.json");
-    auto is = input.open();
+  @param areasFilter
+    The areas to import
 
-    auto cols = InputFiles::DATASETS["popden"].COLS;
+  @param measuresFilter
+    The measures to import, tested in lower case
 
-    auto areasFilter = BethYw::parseAreasArg();
-    auto measuresFilter = BethYw::parseMeasuresArg();
-    auto yearsFilter = BethYw::parseMeasuresArg();
+  @see
+    populateFromWelshStatsJSON() for the other parameters
 
-    Areas data = Areas();
-    areas.populateFromWelshStatsJSON(
-      is,
-      cols,
-      &areasFilter,
-      &measuresFilter,
-      &yearsFilter);
+  @example
+    WelshStatsColumns plan(cols);
+    FieldFilter areaCodes(&areasFilter);
+    FieldFilter measureCodes(&measuresFilter, true);
+    WelshStatsRecord record;
+    record.fields[WelshStatsColumns::AUTH_CODE] = "W06000001";
+    ...
+    areas.importWelshStatsRecord(record, plan, areaCodes, measureCodes, &yearsFilter);
 */
-void Areas::populateFromWelshStatsJSON(std::istream &is,
-            const BethYw::SourceColumnMapping &cols,
-            const StringFilterSet * const areasFilter,
-            const StringFilterSet * const measuresFilter,
+void Areas::importWelshStatsRecord(WelshStatsRecord& record,
+            const WelshStatsColumns &plan,
+            FieldFilter &areasFilter,
+            FieldFilter &measuresFilter,
             const YearFilterTuple * const yearsFilter){
 
     //get years for readability
-    unsigned int yearStart = std::get<0>(*yearsFilter);
-    unsigned int yearEnd = std::get<1>(*yearsFilter);
-
-    json j;
-    is >> j;
-
-    for (auto& el : j["value"].items()) {
-        auto &data = el.value();
-        std::string localAuthorityCode = data[cols.at(BethYw::SourceColumn::AUTH_CODE)];
-
-        //area in not already store and it in the filter or we are imporating them all
-        if(isFilterEmpty(areasFilter)|| filterContains(areasFilter, localAuthorityCode)){
-            if(areas.find(localAuthorityCode) == areas.end()){
-                Area temp = Area(localAuthorityCode);
-                temp.setName("eng", data[cols.at(BethYw::SourceColumn::AUTH_NAME_ENG)]);
-                areas.insert({localAuthorityCode, temp});
-            }
-            /* Here in case a JSON doesn't have a MEASURE_NAME/MEASURE_CODE
-             * if they don't it will use SINGE_MEASURE_****. */
-            std::string measureCode;
-            std::string measureName;
-            try{
-                measureName = data[cols.at(BethYw::SourceColumn::MEASURE_NAME)];
-                measureCode = data[cols.at(BethYw::SourceColumn::MEASURE_CODE)];
-            }catch(const std::out_of_range& error){
-                measureName = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_NAME);
-                measureCode = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_CODE);
-            }
-
-            if(isFilterEmpty(measuresFilter) || filterContains(measuresFilter, BethYw::convertToLower(measureCode))){
+    unsigned int yearStart = yearsFilter == nullptr ? 0 : std::get<0>(*yearsFilter);
+    unsigned int yearEnd = yearsFilter == nullptr ? 0 : std::get<1>(*yearsFilter);
+
+    auto data = [&](WelshStatsColumns::Slot slot) -> const json& {
+        return record.fields[plan.sources[slot]];
+    };
+    stats.rows++;
+
+    //the SAX parser has already tested the areas filter, and not kept the
+    //rest of the record
+    if(record.rejected)
+        return;
+
+    //the filters are tested on the fields as they are, and the strings for
+    //the area and measure are only built once a record has passed them
+    const std::string& localAuthorityCode = data(WelshStatsColumns::AUTH_CODE).get_ref<const std::string&>();
+
+    //area in not already store and it in the filter or we are imporating them all
+    if(areasFilter.accepts(localAuthorityCode)){
+        stats.areasAccepted++;
+        SymbolID id = SymbolTable::areas().intern(localAuthorityCode);
+        Area* area = nullptr;
+        if(storage == AreasStorage::Columns) {
+            if(columns.addArea(id))
+                columns.setName(id, SymbolTable::languages().intern("eng"), data(WelshStatsColumns::AUTH_NAME_ENG));
+            columnsChanged = true;
+        }else{
+            //only a new area takes its name from the dataset
+            bool added = areas.find(id) == areas.end();
+            area = &emplaceArea(id);
+            if(added)
+                area->setName("eng", data(WelshStatsColumns::AUTH_NAME_ENG));
+        }
 
-                double reading;
-                try{
-                    reading = data[cols.at(BethYw::SourceColumn::VALUE)];
-                }catch(const nlohmann::detail::type_error& error){
-                    std::string temp = data[cols.at(BethYw::SourceColumn::VALUE)];
-                    reading = std::stod(temp);
+        const std::string& measureCode = plan.singleMeasure
+            ? plan.singleMeasureCode
+            : data(WelshStatsColumns::MEASURE_CODE).get_ref<const std::string&>();
+
+        if(measuresFilter.accepts(measureCode)){
+            stats.measuresAccepted++;
+
+            const std::string& measureName = plan.singleMeasure
+                ? plan.singleMeasureName
+                : data(WelshStatsColumns::MEASURE_NAME).get_ref<const std::string&>();
+
+            //turns the year string into unsigned int and happened to do some small validation
+            unsigned int year = BethYw::validateYear(data(WelshStatsColumns::YEAR).get_ref<const std::string&>());
+
+            //the value is only read if the year passes the filter
+            bool hasReading = (yearsFilter == nullptr ||(yearStart == 0 && yearEnd == 0)) || (year >= yearStart && year <= yearEnd);
+            double reading = 0;
+            if(hasReading) {
+                //the value is normally a number, but some files give it as a string
+                const json& value = data(WelshStatsColumns::VALUE);
+                if(value.is_string()) {
+                    if(!BethYw::parseDouble(value.get_ref<const std::string&>(), reading))
+                        throw std::invalid_argument("Invalid value: " + value.get<std::string>());
+                }else{
+                    reading = value;
                 }
+                stats.readingsAccepted++;
+            }
 
-                Measure measure = Measure(measureCode, measureName);
-
-                //turns the year string into unsigned int and happened to do some small validation
-                unsigned int year = BethYw::validateYear(data[cols.at(BethYw::SourceColumn::YEAR)]);
-
-                if((yearsFilter == nullptr ||(yearStart == 0 && yearEnd == 0)) || (year >= yearStart && year <= yearEnd))
+            if(storage == AreasStorage::Columns) {
+                columns.addRow(id, columns.measure(measureCode, measureName), year, reading,
+                               hasReading ? ColumnStore::HAS_VALUE : 0);
+            }else{
+                Measure& measure = area->measureFor(measureCode, measureName);
+                if(hasReading)
                     measure.setValue(year, reading);
-                areas.at(localAuthorityCode).setMeasure(measureCode,measure);
             }
         }
     }
@@ -313,6 +1380,9 @@ void Areas::populateFromWelshStatsJSON(std::istream &is,
 
   Note that these files should not include the names for areas
 
+  The stream is read into memory and then split with a CSVTokenizer, so
+  quoted fields (RFC 4180) are supported. Empty values are skipped.
+
   The datasets that will be parsed by this function are
    - complete-popu1009-area.csv
    - complete-popu1009-pop.csv
@@ -369,46 +1439,343 @@ void Areas::populateFromAuthorityByYearCSV(std::istream &is,
                                        const StringFilterSet * const measuresFilter,
                                        const YearFilterTuple * const yearsFilter){
 
-    auto dataCode = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_CODE);
-    auto dataName = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_NAME);
+    if(!(is.good()))
+        return;
+
+    std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    populateFromAuthorityByYearCSV(std::string_view(contents), cols, areasFilter, measuresFilter, yearsFilter);
+}
+
+/*
+  The year of each column of an AuthorityByYearCSV file after the authority
+  code, read from the header row, and the years the years filter accepts.
+  The header is read once and shared by every range of rows.
+*/
+struct AuthorityByYearColumns {
+    std::vector<unsigned int> years;
+
+    //the columns after the last year in the filter are never read
+    std::size_t lastColumn = 0;
+
+    unsigned int yearStart = 0;
+    unsigned int yearEnd = 0;
+    bool allYears = true;
+
+    bool accepts(unsigned int year) const {
+        return allYears || (year >= yearStart && year <= yearEnd);
+    }
+};
+
+/*
+  Read the rows of an AuthorityCodeCSV file into a batch, setting the English
+  and Welsh names of each area that passes the areas filter.
+
+  @param csv
+    A tokenizer at the start of a row
+
+  @param areasFilter
+    The areas to import
 
-    if(is.good() && (isFilterEmpty(measuresFilter) || filterContains(measuresFilter, dataCode))){
+  @param batch
+    The batch to add names to
 
-        //get years for readability
-        unsigned int yearStart = std::get<0>(*yearsFilter);
-        unsigned int yearEnd = std::get<1>(*yearsFilter);
+  @param stats
+    Incremented for each row read and accepted
 
-        bool allYears = yearsFilter == nullptr ||(yearStart == 0 && yearEnd == 0);
+  @throws
+    std::runtime_error if the CSV is malformed
+*/
+static void importAuthorityCodeRows(CSVTokenizer& csv,
+                                    FieldFilter& areasFilter,
+                                    ColumnStore& batch,
+                                    ImportStats& stats) {
+    auto nextField = [&csv]() {
+        std::string_view field;
+        csv.nextField(field);
+        return field;
+    };
+
+    const SymbolID eng = SymbolTable::languages().intern("eng");
+    const SymbolID cym = SymbolTable::languages().intern("cym");
+    while (csv.nextRow()) {
+        std::string_view field = nextField();
+        //skip blank lines
+        if(field.empty())
+            continue;
+        stats.rows++;
+
+        if(areasFilter.accepts(field)){
+            stats.areasAccepted++;
+            SymbolID id = SymbolTable::areas().intern(field);
+            batch.setName(id, eng, std::string(nextField()));
+            batch.setName(id, cym, std::string(nextField()));
+        }
+    }
+}
+
+/*
+  Read the rows of an AuthorityByYearCSV file into a batch, the first
+  reading of each row replacing the area's measure.
+
+  @param csv
+    A tokenizer at the start of a row
 
+  @param columns
+    The years of the columns, from the header row
 
-        //reading first variable which is just AuthorityCode
-        std::string line;
-        std::getline(is,line);
-        getVariableCSV(line);
-        std::vector<unsigned int> years;
-        //gets all the years at the top
-        while(!(line.empty()))
-            years.push_back(std::stol(getVariableCSV(line)));
+  @param areasFilter
+    The areas to import
+
+  @param batch
+    The batch to add rows to
 
+  @param measureIndex
+    The index of the file's measure in batch
 
-        while(std::getline(is, line)){
-            std::string localAuthCode = getVariableCSV(line);
+  @param stats
+    Incremented for each row read and accepted, and each reading accepted
 
-            if(isFilterEmpty(areasFilter) || filterContains(areasFilter, localAuthCode)){
-                Measure measure(dataCode,dataName);
-                for(auto const& year : years){
-                    if(allYears || (year >= yearStart && year <= yearEnd)){
-                        measure.setValue(year,std::stod(getVariableCSV(line)));
-                    }else{
-                        getVariableCSV(line);
-                    }
-                    Area tempArea(localAuthCode);
-                    tempArea.setMeasure(dataCode, measure);
-                    setArea(localAuthCode, tempArea);
+  @throws
+    std::invalid_argument if a value is not a number
+    std::runtime_error if the CSV is malformed
+*/
+static void importAuthorityByYearRows(CSVTokenizer& csv,
+                                      const AuthorityByYearColumns& columns,
+                                      FieldFilter& areasFilter,
+                                      ColumnStore& batch,
+                                      std::uint32_t measureIndex,
+                                      ImportStats& stats) {
+    const std::vector<unsigned int>& years = columns.years;
+    std::string_view field;
+    while(csv.nextRow()){
+        field = std::string_view();
+        csv.nextField(field);
+        //skip blank lines
+        if(field.empty())
+            continue;
+        stats.rows++;
+
+        if(areasFilter.accepts(field)){
+            //the measures filter was checked for the whole file
+            stats.areasAccepted++;
+            stats.measuresAccepted++;
+            SymbolID id = SymbolTable::areas().intern(field);
+            std::uint8_t replace = ColumnStore::REPLACE;
+            for(std::size_t column = 0; column < years.size(); column++){
+                unsigned int year = years[column];
+                //a missing or empty value means there is no data for that year
+                bool hasValue = column < columns.lastColumn && csv.nextField(field) && !field.empty();
+                if(hasValue && columns.accepts(year)) {
+                    double value;
+                    if(!BethYw::parseDouble(field, value))
+                        throw std::invalid_argument("Invalid value: " + std::string(field));
+                    batch.addRow(id, measureIndex, year, value, ColumnStore::HAS_VALUE | replace);
+                    replace = 0;
+                    stats.readingsAccepted++;
                 }
             }
+
+            //an area with no readings still has the (empty) measure
+            if(replace && !years.empty())
+                batch.addRow(id, measureIndex, 0, 0, replace);
+        }
+    }
+}
+
+/*
+  Split the rows of a CSV file into ranges (see CSVTokenizer::splitRows()),
+  read each range into its own ColumnStore batch on a pool of threads, and
+  commit the batches in order, which gives the same data as reading the rows
+  into one batch.
+
+  Nothing is added to this Areas unless every range was read, so if anything
+  goes wrong (a split inside a quoted field, or an error in the data) the
+  rows can be read again on one thread, which gives the same result
+  (including the same exception) as if this had not been tried.
+
+  @param buffer
+    The whole CSV file
+
+  @param from
+    The start of the first row after the header
+
+  @param importRows
+    Reads the rows of a range into a batch, counting them in an ImportStats,
+    as the file would be read on one thread; called from any thread
+
+  @return
+    true if the rows were imported, false if they should be imported on one
+    thread instead
+*/
+bool Areas::importCSVInParallel(std::string_view buffer,
+            std::size_t from,
+            const std::function<void(CSVTokenizer&, ColumnStore&, ImportStats&)>& importRows){
+    std::size_t parts = std::min<std::size_t>(threads, (buffer.size() - from) / MIN_RANGE_BYTES);
+    std::vector<std::size_t> splits = CSVTokenizer::splitRows(buffer, from, parts);
+    if(splits.empty())
+        return false;
+
+    //range i is from bounds[i] up to bounds[i + 1]
+    std::vector<std::size_t> bounds = {from};
+    bounds.insert(bounds.end(), splits.begin(), splits.end());
+    bounds.push_back(buffer.size());
+    const std::size_t ranges = bounds.size() - 1;
+
+    std::vector<ColumnStore> batches(ranges);
+    std::vector<ImportStats> rangeStats(ranges);
+    bool imported = importRanges(ranges, threads, [&](std::size_t i) {
+        CSVTokenizer csv(buffer.substr(bounds[i], bounds[i + 1] - bounds[i]));
+        importRows(csv, batches[i], rangeStats[i]);
+    });
+    if(!imported)
+        return false;
+
+    for(std::size_t i = 0; i < ranges; i++) {
+        commit(std::move(batches[i]), true);
+        stats += rangeStats[i];
+    }
+    return true;
+}
+
+/*
+  The same as populateFromAuthorityCodeCSV() above, but reads the CSV straight
+  from a block of memory (e.g. a MappedInputFile) rather than from a file
+  stream. The bytes are not copied: the CSVTokenizer walks the buffer once.
+
+  @param buffer
+    A view of the whole CSV file
+
+  @see
+    populateFromAuthorityCodeCSV() for the other parameters
+
+  @example
+    MappedInputFile input("data/areas.csv");
+    auto cols = InputFiles::AREAS.COLS;
+
+    Areas data = Areas();
+    areas.populateFromAuthorityCodeCSV(input.open(), cols, &areasFilter);
+*/
+void Areas::populateFromAuthorityCodeCSV(
+    std::string_view buffer,
+    const BethYw::SourceColumnMapping &cols,
+    const StringFilterSet * const areasFilter) {
+
+    if(cols.size() < 3)
+        throw std::out_of_range("Not enough columns");
+
+    CSVTokenizer csv(buffer);
+    std::string_view field;
+
+    //reading first line which is just the name of cols
+    //As coursework states that this should remain constant, throw away the line
+    if(csv.nextRow())
+        while(csv.nextField(field)) {}
+
+    //the names of rejected areas are never read
+    FieldFilter areaCodes(areasFilter);
+
+    //a large file is split into ranges of rows read on several threads
+    const std::size_t from = csv.position();
+    if(threads > 1 && buffer.size() - from >= 2 * MIN_RANGE_BYTES) {
+        bool imported = importCSVInParallel(buffer, from,
+            [&areaCodes](CSVTokenizer& rows, ColumnStore& batch, ImportStats& rangeStats) {
+                FieldFilter rangeAreaCodes = areaCodes;
+                importAuthorityCodeRows(rows, rangeAreaCodes, batch, rangeStats);
+            });
+        if(imported)
+            return;
+    }
+
+    ColumnStore batch;
+    importAuthorityCodeRows(csv, areaCodes, batch, stats);
+    commit(std::move(batch), true);
+}
+
+/*
+  The same as populateFromAuthorityByYearCSV() above, but reads the CSV
+  straight from a block of memory (e.g. a MappedInputFile) rather than from a
+  file stream. The bytes are not copied: the CSVTokenizer walks the buffer
+  once.
+
+  @param buffer
+    A view of the whole CSV file
+
+  @see
+    populateFromAuthorityByYearCSV() for the other parameters
+
+  @example
+    MappedInputFile input("data/complete-popu1009-pop.csv");
+    auto cols = InputFiles::DATASETS["complete-pop"].COLS;
+
+    Areas data = Areas();
+    areas.populateFromAuthorityByYearCSV(input.open(), cols, &areasFilter,
+                                         &measuresFilter, &yearsFilter);
+*/
+void Areas::populateFromAuthorityByYearCSV(std::string_view buffer,
+                                       const BethYw::SourceColumnMapping &cols,
+                                       const StringFilterSet * const areasFilter,
+                                       const StringFilterSet * const measuresFilter,
+                                       const YearFilterTuple * const yearsFilter){
+
+    auto dataCode = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_CODE);
+    auto dataName = cols.at(BethYw::SourceColumn::SINGLE_MEASURE_NAME);
+
+    if(!(isFilterEmpty(measuresFilter) || filterContains(measuresFilter, dataCode)))
+        return;
+
+    AuthorityByYearColumns columns;
+    columns.yearStart = yearsFilter == nullptr ? 0 : std::get<0>(*yearsFilter);
+    columns.yearEnd = yearsFilter == nullptr ? 0 : std::get<1>(*yearsFilter);
+    columns.allYears = columns.yearStart == 0 && columns.yearEnd == 0;
+
+    CSVTokenizer csv(buffer);
+    std::string_view field;
+
+    //reading first variable which is just AuthorityCode
+    //then gets all the years at the top
+    if(csv.nextRow()) {
+        csv.nextField(field);
+        while(csv.nextField(field)) {
+            //checked as the years argument is, so a year such as
+            //4000000000 cannot stretch the Measures' runs of years
+            unsigned int year = 0;
+            try {
+                year = BethYw::validateYear(field);
+            } catch(const std::invalid_argument&) {}
+            if(year == 0)
+                throw std::invalid_argument("Invalid year: " + std::string(field));
+            columns.years.push_back(year);
         }
     }
+
+    //the columns after the last year in the filter are never read
+    for(std::size_t column = 0; column < columns.years.size(); column++) {
+        if(columns.accepts(columns.years[column]))
+            columns.lastColumn = column + 1;
+    }
+
+    //the values of rejected areas are never read
+    FieldFilter areaCodes(areasFilter);
+
+    //a large file is split into ranges of rows read on several threads
+    const std::size_t from = csv.position();
+    if(threads > 1 && buffer.size() - from >= 2 * MIN_RANGE_BYTES) {
+        bool imported = importCSVInParallel(buffer, from,
+            [&](CSVTokenizer& rows, ColumnStore& batch, ImportStats& rangeStats) {
+                FieldFilter rangeAreaCodes = areaCodes;
+                std::uint32_t measureIndex = batch.measure(dataCode, dataName);
+                importAuthorityByYearRows(rows, columns, rangeAreaCodes, batch, measureIndex, rangeStats);
+            });
+        if(imported)
+            return;
+    }
+
+    //each row's readings are built up in a batch, the first reading of a row
+    //replacing the area's measure, and the batch is committed at the end
+    ColumnStore batch;
+    const std::uint32_t measureIndex = batch.measure(dataCode, dataName);
+    importAuthorityByYearRows(csv, columns, areaCodes, batch, measureIndex, stats);
+    commit(std::move(batch), true);
 }
 
 /*
@@ -559,6 +1926,150 @@ void Areas::populate(
   }
 }
 
+/*
+  The same as the populate() function above, but reads the data straight
+  from a block of memory (e.g. a MappedInputFile) instead of a stream.
+
+  @param buffer
+    A view of the whole data file
+
+  @see
+    populate() above for the other parameters
+
+  @example
+    MappedInputFile input("data/popu1009.json");
+    auto cols = InputFiles::DATASETS["popden"].COLS;
+
+    Areas data = Areas();
+    areas.populate(
+      input.open(),
+      DataType::WelshStatsJSON,
+      cols,
+      &areasFilter,
+      &measuresFilter,
+      &yearsFilter);
+*/
+void Areas::populate(
+    std::string_view buffer,
+    const BethYw::SourceDataType &type,
+    const BethYw::SourceColumnMapping &cols,
+    const StringFilterSet * const areasFilter,
+    const StringFilterSet * const measuresFilter,
+    const YearFilterTuple * const yearsFilter){
+  if (type == BethYw::AuthorityCodeCSV && !(cols.size() < 3)) {
+      populateFromAuthorityCodeCSV(buffer, cols, areasFilter);
+
+  } else if(type == BethYw::AuthorityByYearCSV && !(cols.size() < 3)){
+      populateFromAuthorityByYearCSV(buffer, cols, areasFilter, measuresFilter, yearsFilter);
+
+  } else if(type == BethYw::WelshStatsJSON && !(cols.size() < 6 )) {
+      populateFromWelshStatsJSON(buffer, cols, areasFilter, measuresFilter, yearsFilter);
+
+  }else{
+    throw std::runtime_error("Areas::populate: Unexpected data type");
+  }
+}
+
+/*
+  Commit a batch of imported rows (see ColumnStore) into this Areas object
+  at once. With Columns storage the rows are appended to the ColumnStore,
+  otherwise each Area's Measures are built from the rows, with consecutive
+  readings of the same Measure applied to it in one go. Either way the
+  result is the same as importing the rows one at a time.
+
+  Parsers can build a batch without touching the Areas, e.g. for part of a
+  file, and commit it when they are done.
+
+  @param batch
+    The rows to commit, which is left empty
+
+  @param replaceNames
+    If true, names in the batch replace the names of areas already in this
+    Areas object (as setArea() does), otherwise only new areas take them
+
+  @example
+    ColumnStore batch;
+    std::uint32_t pop = batch.measure("Pop", "Population");
+    batch.addRow(SymbolTable::areas().intern("W06000011"), pop, 2015, 242316,
+                 ColumnStore::HAS_VALUE | ColumnStore::REPLACE);
+    data.commit(std::move(batch), true);
+*/
+void Areas::commit(ColumnStore&& batch, bool replaceNames) {
+    //Areas that have already been built are renamed now, as they no longer
+    //take their names from the ColumnStore
+    if(storage == AreasStorage::Columns) {
+        if(replaceNames)
+            batch.applyNamesTo(areas);
+        columns.append(std::move(batch), replaceNames);
+        columnsChanged = true;
+        return;
+    }
+
+    materialise();
+    if(replaceNames)
+        batch.applyNamesTo(areas);
+    batch.applyTo(areas, 0, 0);
+    batch.clear();
+}
+
+/*
+  Merge an Areas object that was populated from a single dataset (e.g. on
+  another thread) into this one. The data is combined in the same way as if
+  the populate() function for that dataset's type had been called on this
+  Areas object directly, so merging shards in the order of the datasets
+  gives exactly the same result as loading the datasets one after another:
+
+   - WelshStatsJSON: new Areas are added, the names of existing Areas are
+     left alone, and Measures are combined with Area::setMeasure()
+   - Anything else: each Area is added with setArea()
+
+  If the shard uses Columns storage, its rows are committed with commit()
+  instead.
+  @param shard
+    The Areas object to merge in, which is left empty
+
+  @param type
+    The BethYw::SourceDataType of the dataset that shard was populated from
+
+  @return
+    void
+
+  @example
+    Areas data = Areas();
+    Areas shard = Areas();
+    shard.populate(is, DataType::WelshStatsJSON, cols, ...);
+    data.merge(std::move(shard), DataType::WelshStatsJSON);
+*/
+void Areas::merge(Areas&& shard, const BethYw::SourceDataType& type) {
+    //rows are committed in order, which combines them in the same way
+    if(shard.storage == AreasStorage::Columns) {
+        commit(std::move(shard.columns), type != BethYw::WelshStatsJSON);
+        shard.areas.clear();
+        shard.rowsApplied = 0;
+        shard.areasApplied = 0;
+
+        stats += shard.stats;
+        shard.stats = ImportStats();
+        return;
+    }
+
+    materialise();
+    shard.materialise();
+    for(auto& area : shard.areas) {
+        auto existing = areas.find(area.first);
+        if(existing == areas.end())
+            areas.emplace(area.first, std::move(area.second));
+        else if(type == BethYw::WelshStatsJSON)
+            existing->second.mergeMeasures(area.second);
+        else
+            setArea(area.second.getLocalAuthorityCode(), std::move(area.second));
+    }
+    shard.areas.clear();
+
+    stats += shard.stats;
+    shard.stats = ImportStats();
+}
+
 /*
   Convert this Areas object, and all its containing Area instances, and
   the Measure instances within those, to JSON strings.
@@ -582,15 +2093,36 @@ void Areas::populate(
     std::cout << data.toJSON();
 */
 std::string Areas::toJSON() const {
-   if(size() == 0)
-       return "{}";
+  std::ostringstream os;
+  writeJSON(os);
+  return os.str();
+}
 
-   json j;
+/*
+  Write this Areas object, and all its containing Area instances, and the
+  Measure instances within those, as JSON to an output stream. The text is
+  the same as toJSON() returns, but is written in a single pass without
+  building a string or json document first.
 
-  for (auto const& area : areas)
-      j[area.second.getLocalAuthorityCode()] = json::parse(area.second.toJSON());
+  @param os
+    The stream to write to
 
-  return j.dump();
+  @example
+    Areas data = Areas();
+    ...
+    data.writeJSON(std::cout);
+*/
+void Areas::writeJSON(std::ostream& os) const {
+  materialise();
+  JSONWriter writer(os);
+
+  writer.beginObject();
+  const SymbolTable& codes = SymbolTable::areas();
+  for (auto const* area : codes.sorted(areas)) {
+      writer.key(codes.name(area->first));
+      area->second.writeJSON(writer);
+  }
+  writer.endObject();
 }
 
 /*
@@ -613,44 +2145,12 @@ std::string Areas::toJSON() const {
     std::cout << areas << std::end;
 */
 std::ostream &operator<<(std::ostream &os, const Areas &areas){
-    for(auto const& area : areas.areas)
-        os << area.second;
+    areas.materialise();
+    for(auto const* area : SymbolTable::areas().sorted(areas.areas))
+        os << area->second;
     return os;
 }
 
-/*
-  Retrieve string form the head of CSV line, and then delete it's form that
-  line.
-
-  @param line
-    A refeance to a CSV line
-
-  @return
-    std::string
-
-  @example
-    std::string line = "give,me,100%,please";
-    std::string give = area.getVariableCSV(line);
-    //line = "me,100%,please"; - now
-*/
-
-std::string Areas::getVariableCSV(std::string& line){
-
-    if(line.find(",") == std::string::npos){
-        std::string out = line;
-        line = "";
-        return out;
-    }
-
-    std::size_t pos = line.find(",");
-    std::string out = line.substr(0,pos);
-
-    //deletes outputted variable
-    line = line.erase (0,pos+1);
-
-    return out;
-}
-
 /*
  * check if a filter is given OR if that filter is empty
 
@@ -676,7 +2176,7 @@ bool Areas::isFilterEmpty(const std::unordered_set<std::string> *const filter) c
     StringFilterSet
 
   @param value
-    std::string
+    const std::string&
 
   @return
     bool
@@ -685,6 +2185,6 @@ bool Areas::isFilterEmpty(const std::unordered_set<std::string> *const filter) c
     StringFilterSet baconFilter;
     bool = filterContains(baconFilter, "Smoked Bacon");
  */
-bool Areas::filterContains(const StringFilterSet * const filter, std::string value){
+bool Areas::filterContains(const StringFilterSet * const filter, const std::string& value){
     return filter->find(value) != filter->end();
 }
@@ -23,16 +23,22 @@
   functions and member variables you need to declare in this class.
  */
 
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <map>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "datasets.h"
 #include "area.h"
-
-
+#include "columns.h"
+#include "symbolmap.h"
 /*
   An alias for filters based on strings such as categorisations e.g. area,
   and measures.
@@ -44,13 +50,82 @@ using StringFilterSet = std::unordered_set<std::string>;
 */
 using YearFilterTuple = std::tuple<unsigned int, unsigned int>;
 
+/*
+  How WelshStatsJSON files are parsed. Streaming handles each record of the
+  "value" array as soon as it has been read, Document parses the whole file
+  into memory first. Scanner reads the records with an ODataScanner, which
+  only converts the fields that are imported, and falls back to Streaming
+  for files it cannot read.
+*/
+enum class WelshStatsJSONMode { Streaming, Document, Scanner };
+
+/*
+  Where the populate() functions put the data they import. Objects builds
+  Area and Measure objects straight away, Columns appends rows to a
+  ColumnStore and only builds the objects when they are asked for.
+*/
+enum class AreasStorage { Objects, Columns };
+/*
+  Counts of what the populate() functions have read, and how much of it got
+  through each filter. The filters are applied in the order areas, measures,
+  years, so each count only includes what passed the filters before it.
+*/
+struct ImportStats {
+    //rows (CSV) or records (JSON) read
+    std::uint64_t rows = 0;
+
+    //rows that passed the areas filter
+    std::uint64_t areasAccepted = 0;
+
+    //rows that also passed the measures filter
+    std::uint64_t measuresAccepted = 0;
+
+    //readings that also passed the years filter
+    std::uint64_t readingsAccepted = 0;
+
+    ImportStats& operator+=(const ImportStats& other);
+    ImportStats operator-(const ImportStats& other) const;
+};
+
 /*
   An alias for the data within an Areas object stores Area objects.
 
   AreasContainer to a valid Standard Library container of your choosing.
+
+  Areas are keyed by the ID of their local authority code in
+  SymbolTable::areas(), so looking one up only hashes an integer. Output is
+  still written in order of the codes (see SymbolTable::sorted()), which is
+  the only time the Areas are sorted.
+
+  The container, and the names, Measures and readings of every Area in it,
+  are allocated from the memory resource given to Areas.
+
+  The container is a policy: any map from SymbolID to Area with the
+  interface of std::unordered_map that Areas uses (find, at, operator[],
+  emplace, try_emplace, clear, iteration, and a constructor taking a
+  std::pmr::memory_resource*) can be used, as long as references to its
+  Areas stay valid when more are added. Only SymbolMap, an open addressing
+  hash map, is built and tested; it is used as looking Areas up by code is
+  the most common operation.
+*/
+
+using AreasContainer = SymbolMap<Area>;
+
+/*
+  The columns of a WelshStatsJSON file, and the fields of one of its records
+  (see areas.cpp).
 */
+struct WelshStatsColumns;
+struct WelshStatsRecord;
 
-using AreasContainer = std::map<std::string, Area>;
+/*
+  Tests the raw text of a field against a filter (see areas.cpp).
+*/
+class FieldFilter;
+
+class ODataScanner;
+
+class CSVTokenizer;
 
 /*
   Areas is a class that stores all the data categorised by area. The 
@@ -61,21 +136,91 @@ class Areas {
 
 private:
     //Key Local authority code | Value Area objects
-    AreasContainer areas;
+    //(with Columns storage, built from columns when first asked for)
+    mutable AreasContainer areas;
+
+    //how populateFromWelshStatsJSON() parses
+    WelshStatsJSONMode jsonMode;
+
+    //where populate() puts the data it imports
+    AreasStorage storage;
+
+    //the number of threads populate() may parse a single file with
+    unsigned int threads = 1;
+
+    //the imported rows, with Columns storage
+    ColumnStore columns;
+
+    //the number of rows and areas of columns that have been applied to
+    //areas, and if anything has been imported into columns since
+    mutable std::size_t rowsApplied = 0;
+    mutable std::size_t areasApplied = 0;
+    mutable bool columnsChanged = false;
+
+    //held while materialise() builds areas, so that const functions called
+    //on several threads at once do not build them at the same time
+    mutable std::mutex materialising;
+
+    //counts of everything imported so far
+    ImportStats stats;
 
     /*----Helper----*/
-    std::string getVariableCSV(std::string& line);
+    void importWelshStatsJSON(nlohmann::json& j,
+                              const WelshStatsColumns &plan,
+                              FieldFilter &areasFilter,
+                              FieldFilter &measuresFilter,
+                              const YearFilterTuple * const yearsFilter);
+    void importWelshStatsRecord(WelshStatsRecord& record,
+                                const WelshStatsColumns &plan,
+                                FieldFilter &areasFilter,
+                                FieldFilter &measuresFilter,
+                                const YearFilterTuple * const yearsFilter);
+    void scanWelshStatsJSON(std::string_view buffer,
+                            bool strict,
+                            const WelshStatsColumns &plan,
+                            FieldFilter &areasFilter,
+                            FieldFilter &measuresFilter,
+                            const YearFilterTuple * const yearsFilter);
+    bool scanWelshStatsJSONInParallel(std::string_view buffer,
+                                      bool strict,
+                                      const WelshStatsColumns &plan,
+                                      const FieldFilter &areasFilter,
+                                      const FieldFilter &measuresFilter,
+                                      const YearFilterTuple * const yearsFilter);
+    void importScannedRecords(ODataScanner& scanner,
+                              const WelshStatsColumns &plan,
+                              FieldFilter &areasFilter,
+                              FieldFilter &measuresFilter,
+                              const YearFilterTuple * const yearsFilter,
+                              std::size_t& imported);
+    bool importCSVInParallel(std::string_view buffer,
+                             std::size_t from,
+                             const std::function<void(CSVTokenizer&, ColumnStore&, ImportStats&)>& importRows);
+    void materialise() const;
 
 public:
   /*----Constructors----*/
   Areas();
+  explicit Areas(std::pmr::memory_resource* resource);
+  Areas(Areas&& other);
+  Areas& operator=(Areas&& other);
 
   /*----Setters---*/
-  void setArea(std::string localAuthorityCode, Area area);
-
+  void setArea(std::string localAuthorityCode, const Area& area);
+  void setArea(std::string localAuthorityCode, Area&& area);
+  Area& emplaceArea(const std::string& localAuthorityCode);
+  Area& emplaceArea(SymbolID localAuthorityID);
+  void setJSONMode(WelshStatsJSONMode mode);
+  void setStorage(AreasStorage storage);
+  void setThreads(unsigned int threads);
   /*----Getters---*/
   Area& getArea(std::string localAuthorityCode);
-
+  const ImportStats& getImportStats() const;
+  WelshStatsJSONMode getJSONMode() const;
+  AreasStorage getStorage() const;
+  unsigned int getThreads() const;
+  const ColumnStore& getColumns() const;
+  std::pmr::memory_resource* getResource() const;
 /*----Populate----*/
   void populate(
       std::istream& is,
@@ -90,6 +235,14 @@ public:
       const StringFilterSet * const measuresFilter = nullptr,
       const YearFilterTuple * const yearsFilter = nullptr) noexcept(false);
 
+  void populate(
+      std::string_view buffer,
+      const BethYw::SourceDataType& type,
+      const BethYw::SourceColumnMapping& cols,
+      const StringFilterSet * const areasFilter = nullptr,
+      const StringFilterSet * const measuresFilter = nullptr,
+      const YearFilterTuple * const yearsFilter = nullptr) noexcept(false);
+
     void populateFromAuthorityCodeCSV(
             std::istream& is,
             const BethYw::SourceColumnMapping& cols,
@@ -107,15 +260,38 @@ public:
                                                const StringFilterSet * const measuresFilter,
                                                const YearFilterTuple * const yearsFilter) noexcept(false);
 
+    void populateFromAuthorityCodeCSV(
+            std::string_view buffer,
+            const BethYw::SourceColumnMapping& cols,
+            const StringFilterSet * const areas = nullptr) noexcept(false);
+
+    void populateFromWelshStatsJSON(std::string_view buffer,
+                                           const BethYw::SourceColumnMapping &cols,
+                                           const StringFilterSet * const areasFilter,
+                                           const StringFilterSet * const measuresFilter,
+                                           const YearFilterTuple * const yearsFilter) noexcept(false);
+
+    void populateFromAuthorityByYearCSV(std::string_view buffer,
+                                               const BethYw::SourceColumnMapping &cols,
+                                               const StringFilterSet * const areasFilter,
+                                               const StringFilterSet * const measuresFilter,
+                                               const YearFilterTuple * const yearsFilter) noexcept(false);
+
   /*----Miscellaneous---*/
+  void commit(ColumnStore&& batch, bool replaceNames);
+  void merge(Areas&& shard, const BethYw::SourceDataType& type);
   std::string toJSON() const;
+  void writeJSON(std::ostream& os) const;
   unsigned int size() const;
   bool isFilterEmpty(const StringFilterSet * const filter) const;
-  bool filterContains(const StringFilterSet * const filter, std::string value);
+  bool filterContains(const StringFilterSet * const filter, const std::string& value);
 
     /*---Override---*/
   friend std::ostream& operator<<(std::ostream& os, const Areas& area);
 
+  /*----Snapshots read and write the areas directly----*/
+  friend class Snapshot;
+
 };
 
 #endif // AREAS_H
\ No newline at end of file
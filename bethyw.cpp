@@ -15,8 +15,16 @@
   calling a series of helper functions.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <iostream>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <vector>
@@ -27,6 +35,10 @@
 #include "datasets.h"
 #include "bethyw.h"
 #include "input.h"
+#include "memory.h"
+#include "numbers.h"
+#include "profile.h"
+#include "snapshot.h"
 
 /*
   Run Beth Yw?, parsing the command line arguments, importing the data,
@@ -64,25 +76,85 @@ int BethYw::run(int argc, char *argv[]) {
    auto areasFilter      = BethYw::parseAreasArg(args);
    auto measuresFilter   = BethYw::parseMeasuresArg(args);
    auto yearsFilter      = BethYw::parseYearsArg(args);
+   auto threads          = BethYw::parseThreadsArg(args);
+
+  // Every pmr allocation (the Areas arena and the arenas of threaded
+  // imports) comes from the heap through here, so it can be counted. It is
+  // passed to the arenas rather than made the default resource, which would
+  // outlive it
+  CountingResource heap;
+
+  // The Area and Measure objects are allocated from an arena, so the whole
+  // object graph takes a few large blocks and is freed at once
+  std::pmr::monotonic_buffer_resource arena(&heap);
+  Areas data(&arena);
+
+  // StatsWales JSON files only have a few of their fields imported, so they
+  // are read with the scanner that skips the rest
+  data.setJSONMode(WelshStatsJSONMode::Scanner);
+
+  // A large JSON dataset imported on its own is split between the threads
+  data.setThreads(threads);
+
+  // The run is always timed, but only reported with --profile
+  Profile profile;
+  profile.countAllocations(&heap);
+
+  // Reuse the data from the last run if nothing it was imported from changed
+  std::string snapshotPath = args.count("cache") ? args["cache"].as<std::string>() : "";
+  std::string key;
+  std::optional<Snapshot> snapshot;
+  bool loaded = false;
+  if (!snapshotPath.empty()) {
+    profile.beginPhase("loadSnapshot");
+    key = BethYw::snapshotKey(dir, datasetsToImport, areasFilter, measuresFilter, yearsFilter);
+    snapshot.emplace(snapshotPath, BethYw::snapshotSources(dir, datasetsToImport));
+    loaded = !key.empty() && snapshot->load(data, key);
+    profile.endPhase();
+  }
 
-  Areas data = Areas();
-
-  BethYw::loadAreas(data, dir, areasFilter);
-
-  BethYw::loadDatasets(data,
-                        dir,
-                        datasetsToImport,
-                        areasFilter,
-                        measuresFilter,
-                        yearsFilter);
+  if (!loaded) {
+    profile.beginPhase("loadAreas");
+    BethYw::loadAreas(data, dir, areasFilter, &profile);
+    profile.endPhase();
+
+    profile.beginPhase("loadDatasets");
+    BethYw::loadDatasets(data,
+                          dir,
+                          datasetsToImport,
+                          areasFilter,
+                          measuresFilter,
+                          yearsFilter,
+                          threads,
+                          &profile,
+                          &heap);
+    profile.endPhase();
+
+    if (!key.empty()) {
+      profile.beginPhase("saveSnapshot");
+      try {
+        snapshot->save(data, key);
+      } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+      }
+      profile.endPhase();
+    }
+  }
 
+  profile.beginPhase("output");
   if (args.count("json")) {
     // The output as JSON
-    std::cout << data.toJSON() << std::endl;
+    data.writeJSON(std::cout);
+    std::cout << std::endl;
   } else {
     // The output as tables
     std::cout << data << std::endl;
   }
+  profile.endPhase();
+
+  if (args.count("profile"))
+    profile.write(std::cerr);
+
   return 0;
 }
 
@@ -129,9 +201,24 @@ cxxopts::Options BethYw::cxxoptsSetup() {
       "inclusive range of years (YYYY-ZZZZ)",
       cxxopts::value<std::string>()->default_value("0"))(
 
+      "t,threads",
+      "The number of datasets to import at the same time, or of threads to "
+      "parse a large JSON dataset with "
+      "(omit or set to 0 to use one thread per CPU core)",
+      cxxopts::value<unsigned int>()->default_value("0"))(
+
+      "c,cache",
+      "A file to keep a snapshot of the imported data in, which is reused "
+      "while the datasets and filters stay the same",
+      cxxopts::value<std::string>())(
+
       "j,json",
       "Print the output as JSON instead of tables.")(
 
+      "profile",
+      "Print a JSON report of the time, rows and memory used by each dataset "
+      "and phase of the run to the standard error.")(
+
       "h,help",
       "Print usage.");
 
@@ -354,6 +441,245 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(cxxopts::ParseResul
     return std::make_tuple(firstYear,secondYear);
 }
 
+/*
+  Parse the threads command line argument, which is optional. It is the
+  number of datasets that are imported at the same time. If it doesn't exist
+  or is 0, one thread per CPU core is used.
+
+  @param args
+    Parsed program arguments
+
+  @return
+    The number of threads to import datasets with (at least 1)
+
+  @example
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args = cxxopts.parse(argc, argv);
+
+    auto threads = BethYw::parseThreadsArg(args);
+*/
+unsigned int BethYw::parseThreadsArg(cxxopts::ParseResult& args){
+    unsigned int threads = 0;
+    if(args.count("threads") != 0)
+        threads = args["threads"].as<unsigned int>();
+
+    if(threads == 0)
+        threads = std::thread::hardware_concurrency();
+
+    return std::max(threads, 1u);
+}
+
+/*
+  Import a single dataset file into an Areas instance, recording how long it
+  took and how many rows were read and accepted by the filters. Used by both
+  loadAreas() and loadDatasets().
+
+  @param areas
+    The Areas instance to import into
+
+  @param dir
+    The directory where the dataset is
+
+  @param dataset
+    The dataset to import
+
+  @param record
+    Filled in with the times and counts for the dataset (see Profile)
+
+  @see
+    loadDatasets() for the other parameters
+
+  @throws
+    std::runtime_error if the file could not be opened or parsed
+*/
+static void importDataset(Areas &areas,
+                          const std::string &dir,
+                          const BethYw::InputFileSource &dataset,
+                          const StringFilterSet &areasFilter,
+                          const StringFilterSet &measuresFilter,
+                          const YearFilterTuple &yearsFilter,
+                          Profile::Dataset &record){
+    record.code = dataset.CODE;
+    record.file = dataset.FILE;
+    const ImportStats before = areas.getImportStats();
+
+    auto start = Profile::Clock::now();
+    MappedInputFile datasetFile(dir + dataset.FILE);
+    std::string_view bytes = datasetFile.open();
+    record.bytes = bytes.size();
+    record.openSeconds = Profile::secondsSince(start);
+
+    start = Profile::Clock::now();
+    areas.populate(bytes, dataset.PARSER, dataset.COLS, &areasFilter, &measuresFilter, &yearsFilter);
+    record.parseSeconds = Profile::secondsSince(start);
+
+    record.stats = areas.getImportStats() - before;
+    record.peakRSS = Profile::peakRSS();
+}
+
+/*
+ * Compares two string cap insensitively.
+
+  @param a
+    std::string
+
+  @param b
+    std::string
+
+  @return
+    bool
+
+  @example
+    std::string a;
+    std::string b;
+    bool = BethYw::insensitiveEquals(a,b);
+    */
+bool BethYw::insensitiveEquals(std::string const a, std::string const b){
+    return convertToLower(a) == convertToLower(b);
+}
+
+/*
+ * Turns a year as a string into a unsigned int
+ * and check if it is valid (if it in the future or has letter)
+ * SEPICAL CASE: "0" returns 0;
+
+  @param yearSting
+    std::string_view
+
+  @return
+    unsigned int
+
+  @throw
+    std::invalid_argument if year is before 1000 AD
+
+  @throw
+    std::invalid_argument if yearString has a no digits char
+
+  @throw
+    std::invalid_argument if dates is in the future
+
+  @example
+    unsigned int year = BethYw::validateYear("2015");
+    */
+unsigned int BethYw::validateYear(std::string_view yearSting){
+
+    if(yearSting == "0")
+        return 0;
+
+    unsigned int year;
+    if(yearSting.size() != 4 || !BethYw::parseUnsigned(yearSting, year))
+        throw (std::invalid_argument("Invalid input for years argument"));
+
+    if ( year >= 2021)
+        throw (std::invalid_argument("Invalid input for years argument"));
+
+    return year;
+}
+
+/*
+    Covert string into a string with only lower case letters
+
+  @param string
+    std::string
+
+  @return
+    std::string
+
+  @example
+    std::string message = "YoU WaNT TO gIVe me FuLL MaRKs";
+    std::string newMessage = BethYw::convertToLower(message);
+    (newMessage == "you want to give me full marks) == ture;
+ */
+std::string BethYw::convertToLower(const std::string string) {
+    std::string lower = "";
+    for (unsigned i = 0; i < string.size(); i++)
+        lower += std::tolower(string[i]);
+    return lower;
+}
+
+/*
+  List the source files of the data imported by this run: areas.csv and then
+  each dataset file, in the order they are imported.
+
+  @param dir
+    Directory where the source files are
+
+  @param datasetsToImport
+    The datasets that will be imported
+
+  @return
+    The paths of the source files
+
+  @example
+    Snapshot snapshot(path, BethYw::snapshotSources(dir, datasetsToImport));
+*/
+std::vector<std::string> BethYw::snapshotSources(const std::string &dir,
+                                                 const std::vector<InputFileSource> &datasetsToImport) {
+  std::vector<std::string> files = {dir + InputFiles::AREAS.FILE};
+  for (auto const &dataset : datasetsToImport)
+    files.push_back(dir + dataset.FILE);
+  return files;
+}
+
+/*
+  Build the key for a snapshot of the data imported by this run (see the
+  Snapshot class). The key records the path of areas.csv and of each dataset
+  file, in the order they are imported, along with the filters. A snapshot
+  saved with a different key is out of date. Whether the files themselves
+  have changed is checked by the Snapshot, so no file is read here.
+
+  @param dir
+    Directory where the source files are
+
+  @param datasetsToImport
+    The datasets that will be imported
+
+  @param areasFilter
+    An unordered set of areas to filter, or empty to import all areas
+
+  @param measuresFilter
+    An unordered set of measures to filter, or empty to import all measures
+
+  @param yearsFilter
+    A tuple of the first and last years to import, or (0, 0) for all years
+
+  @return
+    The key, or an empty string if a source file does not exist (in which
+    case no snapshot should be used)
+
+  @example
+    auto key = BethYw::snapshotKey(dir, datasetsToImport, areasFilter,
+                                   measuresFilter, yearsFilter);
+*/
+std::string BethYw::snapshotKey(const std::string &dir,
+                                const std::vector<InputFileSource> &datasetsToImport,
+                                const StringFilterSet &areasFilter,
+                                const StringFilterSet &measuresFilter,
+                                const YearFilterTuple &yearsFilter) {
+  std::string key;
+  for (auto const &file : snapshotSources(dir, datasetsToImport)) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(file, error))
+      return "";
+    key += "file " + file + "\n";
+  }
+
+  // Filters are unordered, so sort them to give the same key every time
+  for (auto filter : {std::make_pair("areas", &areasFilter), std::make_pair("measures", &measuresFilter)}) {
+    std::vector<std::string> values(filter.second->begin(), filter.second->end());
+    std::sort(values.begin(), values.end());
+
+    key += filter.first;
+    for (auto const &value : values)
+      key += " " + value;
+    key += "\n";
+  }
+
+  key += "years " + std::to_string(std::get<0>(yearsFilter)) + "-"
+       + std::to_string(std::get<1>(yearsFilter)) + "\n";
+  return key;
+}
+
 /*
   Load the areas.csv file from the directory `dir`. Parse the file and
   create the appropriate Area objects inside the Areas object passed to
@@ -362,9 +688,8 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(cxxopts::ParseResul
   areas.csv is guaranteed to be formatted as:
     Local authority code,Name (eng),Name (cym)
 
-  Hint: To implement this function. First you will need create an InputFile 
-  object with the filename of the areas file, open it, and then pass reference 
-  to the stream to the Areas::populate() function.
+  The file is memory mapped with a MappedInputFile, and the mapped bytes are
+  passed straight to the Areas::populate() function.
 
   Hint 2: you can retrieve the specific filename for a dataset, e.g. for the 
   areas.csv file, from the InputFileSource's FILE member variable
@@ -379,6 +704,9 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(cxxopts::ParseResul
   @param areasFilter
     An unordered set of areas to filter, or empty to import all areas
 
+  @param profile
+    A Profile to record the import in, or nullptr if not profiling
+
   @return
     void
 
@@ -387,17 +715,20 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(cxxopts::ParseResul
 
     BethYw::loadAreas(areas, "data", BethYw::parseAreasArg(args));
 */
-void BethYw::loadAreas(Areas &areas, std::string dir, std::unordered_set<std::string> areasFilter){
-    InputFile areasFile(dir + InputFiles::AREAS.FILE);
-    auto fileNameCSV = InputFiles::AREAS.FILE;
-    auto cols = InputFiles::AREAS.COLS;
-    auto type = InputFiles::AREAS.PARSER;
+void BethYw::loadAreas(Areas &areas, std::string dir, std::unordered_set<std::string> areasFilter, Profile *profile){
+    //areas.csv only has the one filter
+    const StringFilterSet measuresFilter;
+    const YearFilterTuple yearsFilter = std::make_tuple(0, 0);
+
+    Profile::Dataset record;
     try {
-        areas.populate(areasFile.open(), type, cols, &areasFilter, nullptr, nullptr);
+        importDataset(areas, dir, InputFiles::AREAS, areasFilter, measuresFilter, yearsFilter, record);
     }catch(const std::runtime_error& error){
         std::cerr << "Error importing dataset: " << std::endl << error.what();
         exit(0);
     }
+    if(profile != nullptr)
+        profile->addDataset(record);
 }
 
 /*
@@ -407,6 +738,14 @@ void BethYw::loadAreas(Areas &areas, std::string dir, std::unordered_set<std::st
   The actual filtering will be done by the Areas::populate() function, thus 
   you need to merely pass pointers on to these flters.
 
+  While a dataset is being parsed, the next ones are read into the page cache
+  on a background thread (see ReadAhead).
+
+  With more than one thread, each dataset is parsed on a worker thread into
+  its own Areas shard, and the shards are then merged into `areas` in the
+  order of `datasetsToImport` (see Areas::merge()). The result is the same as
+  importing the datasets one after another.
+
   This function should promise not to throw an exception. If there is an
   error/exception thrown in any function called by thus function, catch it and
   output 'Error importing dataset:', followed by a new line and then the output
@@ -433,6 +772,16 @@ void BethYw::loadAreas(Areas &areas, std::string dir, std::unordered_set<std::st
     An two-pair tuple of unsigned ints corresponding to the range of years 
     to import, which should both be 0 to import all years.
 
+  @param threads
+    The number of datasets to import at the same time
+
+  @param profile
+    A Profile to record each dataset's import in, or nullptr if not profiling
+
+  @param upstream
+    The memory resource the arenas of a threaded import take their blocks
+    from (the default resource unless given)
+
   @return
     void
 
@@ -445,113 +794,91 @@ void BethYw::loadAreas(Areas &areas, std::string dir, std::unordered_set<std::st
       BethYw::parseDatasetsArgument(args),
       BethYw::parseAreasArg(args),
       BethYw::parseMeasuresArg(args),
-      BethYw::parseYearsArg(args));
+      BethYw::parseYearsArg(args),
+      BethYw::parseThreadsArg(args));
 */
 void BethYw::loadDatasets(Areas &areas,
                         std::string dir,
                         std::vector<InputFileSource>  datasetsToImport,
                           const StringFilterSet areasFilter,
                           const StringFilterSet measuresFilter,
-                          const YearFilterTuple yearsFilter){
-
-        for(auto const& dataset : datasetsToImport) {
-            InputFile areasFile(dir + dataset.FILE);
+                          const YearFilterTuple yearsFilter,
+                          unsigned int threads,
+                          Profile *profile,
+                          std::pmr::memory_resource *upstream){
+
+    //what was recorded for each dataset, if profiling
+    std::vector<Profile::Dataset> records(datasetsToImport.size());
+
+    //the files are read in the background, ahead of the one being parsed
+    std::vector<std::string> paths;
+    for(auto const& dataset : datasetsToImport)
+        paths.push_back(dir + dataset.FILE);
+    ReadAhead readAhead(paths);
+
+    if(threads <= 1 || datasetsToImport.size() <= 1) {
+        for(std::size_t i = 0; i < datasetsToImport.size(); i++) {
+            readAhead.opening(i);
             try{
-                areas.populate(areasFile.open(), dataset.PARSER, dataset.COLS, &areasFilter, &measuresFilter, &yearsFilter);
+                importDataset(areas, dir, datasetsToImport[i], areasFilter, measuresFilter, yearsFilter, records[i]);
             }catch(const std::runtime_error & error) {
                 std::cerr << "Error importing dataset: " << std::endl << error.what();
                 exit(0);
             }
+            if(profile != nullptr)
+                profile->addDataset(records[i]);
         }
-}
-
-/*
- * Compares two string cap insensitively.
-
-  @param a
-    std::string
-
-  @param b
-    std::string
-
-  @return
-    bool
-
-  @example
-    std::string a;
-    std::string b;
-    bool = BethYw::insensitiveEquals(a,b);
-    */
-bool BethYw::insensitiveEquals(std::string const a, std::string const b){
-    return convertToLower(a) == convertToLower(b);
-}
-
-/*
- * Turns a year as a string into a unsigned int
- * and check if it is valid (if it in the future or has letter)
- * SEPICAL CASE: "0" returns 0;
-
-  @param a
-    std::string
-
-  @param b
-    std::string
-
-  @return
-    bool
-
-  @throw
-    std::invalid_argument if year is before 1000 AD
-
-  @throw
-    std::invalid_argument if yearString has a no digits char
-
-  @throw
-    std::invalid_argument if dates is in the future
-
-  @example
-    std::string a;
-    std::string b;
-    bool = BethYw::insensitiveEquals(a,b)
-    */
-unsigned int BethYw::validateYear(std::string yearSting){
-
-    if(yearSting == "0")
-        return 0;
-
-    if(yearSting.size() != 4)
-        throw (std::invalid_argument("Invalid input for years argument"));
-
-    for(char & ch : yearSting){
-        if (!isdigit(ch))
-            throw (std::invalid_argument("Invalid input for years argument"));
+        return;
     }
 
-    unsigned int year = std::stoi(yearSting);
-
-    if ( year >= 2021)
-        throw (std::invalid_argument("Invalid input for years argument"));
-
-    return year;
-}
-
-/*
-    Covert string into a string with only lower case letters
+    //each dataset is parsed into its own shard, and any error is kept for later.
+    //Each shard allocates from its own arena (arenas are not thread safe), all
+    //of which are freed at once after the shards are merged
+    std::deque<std::pmr::monotonic_buffer_resource> arenas;
+    std::vector<Areas> shards;
+    shards.reserve(datasetsToImport.size());
+    for(std::size_t i = 0; i < datasetsToImport.size(); i++) {
+        arenas.emplace_back(upstream);
+        shards.emplace_back(&arenas.back());
+        shards.back().setStorage(areas.getStorage());
+        shards.back().setJSONMode(areas.getJSONMode());
+    }
+    std::vector<std::exception_ptr> errors(datasetsToImport.size());
+    std::atomic<std::size_t> next(0);
 
-  @param string
-    std::string
+    auto worker = [&]() {
+        for(std::size_t i = next++; i < datasetsToImport.size(); i = next++) {
+            readAhead.opening(i);
+            try{
+                importDataset(shards[i], dir, datasetsToImport[i], areasFilter, measuresFilter, yearsFilter, records[i]);
+            }catch(...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned int i = 0; i < threads && i < datasetsToImport.size(); i++)
+        pool.emplace_back(worker);
+    for(auto& thread : pool)
+        thread.join();
+
+    //merge (and report errors) in the order the datasets were given, so the
+    //result is the same as importing them one after another
+    for(std::size_t i = 0; i < datasetsToImport.size(); i++) {
+        try{
+            if(errors[i])
+                std::rethrow_exception(errors[i]);
+        }catch(const std::runtime_error & error) {
+            std::cerr << "Error importing dataset: " << std::endl << error.what();
+            exit(0);
+        }
 
-  @return
-    std::string
+        auto start = Profile::Clock::now();
+        areas.merge(std::move(shards[i]), datasetsToImport[i].PARSER);
+        records[i].mergeSeconds = Profile::secondsSince(start);
 
-  @example
-    std::string message = "YoU WaNT TO gIVe me FuLL MaRKs";
-    std::string newMessage = BethYw::convertToLower(message);
-    (newMessage == "you want to give me full marks) == ture;
- */
-std::string BethYw::convertToLower(const std::string string) {
-    std::string lower = "";
-    for (unsigned i = 0; i < string.size(); i++)
-        lower += std::tolower(string[i]);
-    return lower;
+        if(profile != nullptr)
+            profile->addDataset(records[i]);
+    }
 }
@@ -11,13 +11,16 @@
   running Beth Yw?
  */
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
 #include "lib_cxxopts.hpp"
 #include "datasets.h"
 #include "areas.h"
+#include "profile.h"
 
 const char DIR_SEP =
 #ifdef _WIN32
@@ -57,9 +60,12 @@ std::unordered_set<std::string> parseMeasuresArg(cxxopts::ParseResult& args);
 
 std::tuple<unsigned int, unsigned int> parseYearsArg(cxxopts::ParseResult& args);
 
-void loadAreas(Areas &areas, std::string dir, std::unordered_set<std::string> areasFilter);
+unsigned int parseThreadsArg(cxxopts::ParseResult& args);
 
-unsigned int validateYear(std::string yearSting);
+void loadAreas(Areas &areas, std::string dir, std::unordered_set<std::string> areasFilter,
+               Profile *profile = nullptr);
+
+unsigned int validateYear(std::string_view yearSting);
 
 bool insensitiveEquals(std::string const a, std::string const b);
 
@@ -71,10 +77,20 @@ void loadDatasets(Areas &areas,
                               std::vector<InputFileSource>  datasetsToImport,
                               const StringFilterSet areasFilter,
                               const StringFilterSet  measuresFilter,
-                              const YearFilterTuple  yearsFilter) noexcept(false);
+                              const YearFilterTuple  yearsFilter,
+                              unsigned int threads = 1,
+                              Profile *profile = nullptr,
+                              std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) noexcept(false);
+
+std::vector<std::string> snapshotSources(const std::string &dir,
+                                         const std::vector<InputFileSource> &datasetsToImport);
 
+std::string snapshotKey(const std::string &dir,
+                        const std::vector<InputFileSource> &datasetsToImport,
+                        const StringFilterSet &areasFilter,
+                        const StringFilterSet &measuresFilter,
+                        const YearFilterTuple &yearsFilter);
 
-std::string getVariableCSV(std::string& line);
 } // namespace BethYw
 
 #endif // BETHYW_H_
\ No newline at end of file
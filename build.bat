@@ -2,9 +2,10 @@
 
 SET bin_dir=bin
 SET tests_dir=tests
-SET source_files=bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp
+SET source_files=bethyw.cpp input.cpp csv.cpp numbers.cpp symbols.cpp memory.cpp columns.cpp jsonwriter.cpp odata.cpp areas.cpp area.cpp measure.cpp snapshot.cpp profile.cpp generator.cpp
 SET main_file=main.cpp
 SET executable=%bin_dir%\bethyw.exe
+SET extra_flags=
 
 COPY bin\bethyw2.exe bin\bethyw.exe
 
@@ -18,13 +19,32 @@ IF %testStr%==test (
   SET executable=%bin_dir%\bethyw-test.exe
 
   IF NOT EXIST %bin_dir%\catch.o (
-     g++ --std=c++11 -c lib_catch_main.cpp -o %bin_dir%\catch.o
+     g++ --std=c++17 -c lib_catch_main.cpp -o %bin_dir%\catch.o
   )
 )
+REM "bench" on its own builds all of the benchmarks
+SET bench_file=%1%
+IF "%1"=="bench" SET bench_file=benchall
+IF %testStr%==benc (
+  SET source_files=%source_files% %tests_dir%\%bench_file%.cpp
+  SET main_file=%bin_dir%\catch-bench.o
+  SET executable=%bin_dir%\bethyw-bench.exe
+  SET extra_flags=-O2 -DCATCH_CONFIG_ENABLE_BENCHMARKING
+
+  IF NOT EXIST %bin_dir%\catch-bench.o (
+     g++ --std=c++17 -O2 -DCATCH_CONFIG_ENABLE_BENCHMARKING -c lib_catch_main.cpp -o %bin_dir%\catch-bench.o
+  )
+)
+IF "%1"=="generate" (
+  SET source_files=generator.cpp
+  SET main_file=generate.cpp
+  SET executable=%bin_dir%\bethyw-generate.exe
+  SET extra_flags=-O2
+)
 
 :compile
 IF NOT EXIST %bin_dir% MKDIR %bin_dir%
 IF EXIST %executable% DEL %executable%
-g++ --std=c++14 -Wall %source_files% %main_file% -o %executable%
+g++ --std=c++17 -Wall -pthread %extra_flags% %source_files% %main_file% -o %executable%
 
 :end
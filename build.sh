@@ -2,15 +2,17 @@
 
 BIN_DIR="bin"
 TESTS_DIR="tests"
-SOURCE_FILES="bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp"
+SOURCE_FILES="bethyw.cpp input.cpp csv.cpp numbers.cpp symbols.cpp memory.cpp columns.cpp jsonwriter.cpp odata.cpp areas.cpp area.cpp measure.cpp snapshot.cpp profile.cpp generator.cpp"
 MAIN_FILE="main.cpp"
 EXECUTABLE="./${BIN_DIR}/bethyw"
 
 set -x
 cd "${0%/*}"
 
+EXTRA_FLAGS=""
+
 if [ $# -gt 1 ]; then
-  echo "Unknown arguments!" "Only one argument accepted, and must begin with test"
+  echo "Unknown arguments!" "Only one argument accepted, and must begin with test or bench, or be generate"
   exit
 elif [ $# -eq 1 ]; then
   if [[ $1 == test* ]]; then
@@ -20,11 +22,33 @@ elif [ $# -eq 1 ]; then
 
     # Do we need to compile Catch2?
     if [ ! -f ./${BIN_DIR}/catch.o ]; then
-      g++ --std=c++11 -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch.o
+      g++ --std=c++17 -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch.o
+    fi
+  elif [[ $1 == bench* ]]; then
+    # "bench" on its own builds all of the benchmarks
+    BENCH_FILE=$1
+    if [[ $1 == bench ]]; then
+      BENCH_FILE="benchall"
+    fi
+
+    SOURCE_FILES="${SOURCE_FILES} ./${TESTS_DIR}/${BENCH_FILE}.cpp"
+    MAIN_FILE="./${BIN_DIR}/catch-bench.o"
+    EXECUTABLE="./${BIN_DIR}/bethyw-bench"
+    EXTRA_FLAGS="-O2 -DCATCH_CONFIG_ENABLE_BENCHMARKING"
+
+    # Do we need to compile Catch2 (with benchmarking)?
+    if [ ! -f ./${BIN_DIR}/catch-bench.o ]; then
+      g++ --std=c++17 ${EXTRA_FLAGS} -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch-bench.o
     fi
+  elif [[ $1 == generate ]]; then
+    # The synthetic dataset generator is a separate program
+    SOURCE_FILES="generator.cpp"
+    MAIN_FILE="generate.cpp"
+    EXECUTABLE="./${BIN_DIR}/bethyw-generate"
+    EXTRA_FLAGS="-O2"
   fi
 fi
 
 mkdir -p ${BIN_DIR}
 rm ${EXECUTABLE} 2> /dev/null
-g++ --std=c++14 -pedantic -Wall ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE}
\ No newline at end of file
+g++ --std=c++17 -pedantic -Wall -pthread ${EXTRA_FLAGS} ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE}
\ No newline at end of file
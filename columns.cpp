@@ -0,0 +1,301 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the ColumnStore class. See the
+  header file for additional comments.
+*/
+
+#include <stdexcept>
+
+#include "columns.h"
+#include "bethyw.h"
+
+/*
+  Add an area to the area dictionary, if it is not already there.
+
+  @param area
+    The ID of the area's local authority code
+
+  @return
+    true if the area is new
+
+  @example
+    ColumnStore columns;
+    SymbolID id = SymbolTable::areas().intern("W06000011");
+    if(columns.addArea(id))
+      columns.setName(id, SymbolTable::languages().intern("eng"), "Swansea");
+*/
+bool ColumnStore::addArea(SymbolID area) {
+    return areaNames.try_emplace(area).second;
+}
+
+/*
+  Set the name of an area in a language, replacing any name it already has
+  in that language. The area is added to the dictionary if needed.
+
+  @param area
+    The ID of the area's local authority code
+
+  @param lang
+    The ID of the (lower case) language code
+
+  @param name
+    The name of the area in that language
+
+  @example
+    columns.setName(id, SymbolTable::languages().intern("cym"), "Abertawe");
+*/
+void ColumnStore::setName(SymbolID area, SymbolID lang, std::string name) {
+    areaNames[area][lang] = std::move(name);
+}
+
+/*
+  Get the index of a measure in the measure dictionary, adding it if needed.
+  Measures with the same codename but different labels are different
+  entries, as each row keeps the label it was imported with.
+
+  @param codename
+    The codename of the measure, as given in the dataset
+
+  @param label
+    The label of the measure
+
+  @return
+    The index of the measure
+
+  @example
+    std::uint32_t pop = columns.measure("Pop", "Population");
+*/
+std::uint32_t ColumnStore::measure(std::string_view codename, std::string_view label) {
+    if(hasLastMeasure && codename == lastCodename && label == lastLabel)
+        return lastMeasure;
+
+    SymbolID codenameID = SymbolTable::measures().intern(codename);
+    auto found = measureIndexes.find(std::make_pair(codenameID, std::string(label)));
+    if(found == measureIndexes.end()) {
+        SymbolID key = SymbolTable::measures().intern(BethYw::convertToLower(std::string(codename)));
+        std::uint32_t index = measureEntries.size();
+        measureEntries.push_back({key, codenameID, std::string(label)});
+        found = measureIndexes.emplace(std::make_pair(codenameID, std::string(label)), index).first;
+    }
+
+    lastCodename.assign(codename.data(), codename.size());
+    lastLabel.assign(label.data(), label.size());
+    lastMeasure = found->second;
+    hasLastMeasure = true;
+    return lastMeasure;
+}
+
+/*
+  Append a row. The area is added to the area dictionary if needed.
+
+  @param area
+    The ID of the area's local authority code
+
+  @param measure
+    The index of the measure, from measure()
+
+  @param year
+    The year of the reading (unused without HAS_VALUE)
+
+  @param value
+    The reading (unused without HAS_VALUE)
+
+  @param flags
+    HAS_VALUE and/or REPLACE, or 0 for a row that only makes sure the
+    Measure exists
+
+  @example
+    columns.addRow(id, pop, 2015, 238500, ColumnStore::HAS_VALUE);
+*/
+void ColumnStore::addRow(SymbolID area, std::uint32_t measure, unsigned int year, double value, std::uint8_t flags) {
+    addArea(area);
+    areaColumn.push_back(area);
+    measureColumn.push_back(measure);
+    yearColumn.push_back(year);
+    valueColumn.push_back(value);
+    flagColumn.push_back(flags);
+}
+
+/*
+  Append the rows and dictionaries of another ColumnStore (e.g. a shard
+  imported on another thread), which is left empty.
+
+  @param other
+    The ColumnStore to append
+
+  @param replaceNames
+    If true, names in other replace names in this store (as Areas::setArea()
+    does), otherwise only the names of areas new to this store are kept (as
+    the WelshStatsJSON parser does)
+
+  @example
+    columns.append(std::move(shard.columns), false);
+*/
+void ColumnStore::append(ColumnStore&& other, bool replaceNames) {
+    //into an empty store, the rows and dictionaries are taken over whole
+    if(size() == 0 && areaNames.empty() && measureEntries.empty()) {
+        std::swap(*this, other);
+        other.clear();
+        return;
+    }
+
+    for(auto& area : other.areaNames) {
+        auto inserted = areaNames.try_emplace(area.first, std::move(area.second));
+        if(!inserted.second && replaceNames) {
+            for(auto& name : area.second)
+                inserted.first->second[name.first] = std::move(name.second);
+        }
+    }
+
+    //the measure indexes of other are remapped into this dictionary
+    std::vector<std::uint32_t> remap;
+    remap.reserve(other.measureEntries.size());
+    for(auto const& entry : other.measureEntries)
+        remap.push_back(measure(SymbolTable::measures().name(entry.codename), entry.label));
+
+    areaColumn.insert(areaColumn.end(), other.areaColumn.begin(), other.areaColumn.end());
+    for(auto measure : other.measureColumn)
+        measureColumn.push_back(remap[measure]);
+    yearColumn.insert(yearColumn.end(), other.yearColumn.begin(), other.yearColumn.end());
+    valueColumn.insert(valueColumn.end(), other.valueColumn.begin(), other.valueColumn.end());
+    flagColumn.insert(flagColumn.end(), other.flagColumn.begin(), other.flagColumn.end());
+
+    other.clear();
+}
+
+/*
+  Get the number of rows.
+
+  @return
+    The number of rows
+
+  @example
+    for(std::size_t row = 0; row < columns.size(); row++)
+      ...
+*/
+std::size_t ColumnStore::size() const {
+    return areaColumn.size();
+}
+
+/*
+  Get the number of areas in the area dictionary.
+
+  @return
+    The number of areas
+
+  @example
+    auto areas = columns.areaCount();
+*/
+std::size_t ColumnStore::areaCount() const {
+    return areaNames.size();
+}
+
+/*
+  The area column: the ID (in SymbolTable::areas()) of each row's area.
+
+  @return
+    The column, indexed by row
+
+  @example
+    auto code = SymbolTable::areas().name(columns.areas()[row]);
+*/
+const std::vector<SymbolID>& ColumnStore::areas() const {
+    return areaColumn;
+}
+
+/*
+  The measure column: the index of each row's measure in the dictionary.
+
+  @return
+    The column, indexed by row
+
+  @example
+    auto label = columns.getMeasure(columns.measures()[row]).label;
+*/
+const std::vector<std::uint32_t>& ColumnStore::measures() const {
+    return measureColumn;
+}
+
+/*
+  The year column. Only rows with the HAS_VALUE flag have a year.
+
+  @return
+    The column, indexed by row
+
+  @example
+    auto year = columns.years()[row];
+*/
+const std::vector<unsigned int>& ColumnStore::years() const {
+    return yearColumn;
+}
+
+/*
+  The value column. Only rows with the HAS_VALUE flag have a value.
+
+  @return
+    The column, indexed by row
+
+  @example
+    double total = 0;
+    for(std::size_t row = 0; row < columns.size(); row++)
+      if(columns.flags()[row] & ColumnStore::HAS_VALUE)
+        total += columns.values()[row];
+*/
+const std::vector<double>& ColumnStore::values() const {
+    return valueColumn;
+}
+
+/*
+  The flags column (HAS_VALUE and REPLACE).
+
+  @return
+    The column, indexed by row
+
+  @example
+    bool hasValue = columns.flags()[row] & ColumnStore::HAS_VALUE;
+*/
+const std::vector<std::uint8_t>& ColumnStore::flags() const {
+    return flagColumn;
+}
+
+/*
+  Look up a measure in the measure dictionary.
+
+  @param measure
+    The index of the measure, e.g. from the measure column
+
+  @return
+    The measure's key, codename and label
+
+  @throws
+    std::out_of_range if there is no measure with that index
+
+  @example
+    auto const& measure = columns.getMeasure(columns.measures()[row]);
+*/
+const ColumnStore::MeasureEntry& ColumnStore::getMeasure(std::uint32_t measure) const {
+    return measureEntries.at(measure);
+}
+
+/*
+  Remove every row and dictionary entry.
+
+  @example
+    columns.clear();
+*/
+void ColumnStore::clear() {
+    areaNames.clear();
+    measureEntries.clear();
+    measureIndexes.clear();
+    hasLastMeasure = false;
+    areaColumn.clear();
+    measureColumn.clear();
+    yearColumn.clear();
+    valueColumn.clear();
+    flagColumn.clear();
+}
@@ -0,0 +1,212 @@
+#ifndef COLUMNS_H_
+#define COLUMNS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the ColumnStore class, a columnar
+  alternative to the Area and Measure objects for holding imported data.
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "area.h"
+#include "symbolmap.h"
+#include "symbols.h"
+
+/*
+  A ColumnStore holds imported readings as parallel columns, one entry per
+  row: the area ID, the measure (an index into the measure dictionary), the
+  year, the value and some flags. Alongside the columns are two
+  dictionaries: the names of each area, and the codename and label of each
+  measure. Areas, measures and languages are IDs in the shared SymbolTables.
+
+  Rows are only ever appended, in the order they were imported. A scan over
+  one column (e.g. every value for a year) reads a single contiguous array,
+  rather than following pointers through Areas, Area and Measure.
+
+  Areas can populate a ColumnStore instead of Area objects (see
+  Areas::setStorage()). The Area and Measure objects are then built from the
+  rows only when they are asked for, by replaying the rows in order with
+  applyTo(). Each row is applied as Area::setMeasure() would be, unless it
+  has the REPLACE flag, in which case the Area's Measure is replaced first
+  (as the AuthorityByYearCSV parser does with Areas::setArea()).
+
+  A ColumnStore is also a batch: a parser can build its rows in one, away
+  from the Areas, and then commit them all at once with Areas::commit().
+*/
+class ColumnStore {
+public:
+    /*
+      An entry in the measure dictionary.
+    */
+    struct MeasureEntry {
+        //the key of the Measure in an Area (the lower case code)
+        SymbolID key;
+
+        //the codename of the Measure, as it was given
+        SymbolID codename;
+
+        //the label of the Measure
+        std::string label;
+    };
+
+    //row flag: the row has a reading (otherwise year and value are unused,
+    //and the row only makes sure the Measure exists)
+    static const std::uint8_t HAS_VALUE = 1;
+
+    //row flag: the Area's Measure is replaced, rather than merged with
+    static const std::uint8_t REPLACE = 2;
+
+private:
+    //Key = area ID | Value = names of the area (language ID to name), in
+    //the order the areas were added, so applyTo() adds new Areas in that order
+    //(allocated with new, like the columns, not from the default resource)
+    SymbolMap<std::map<SymbolID, std::string>> areaNames{std::pmr::new_delete_resource()};
+
+    //Index = measure index | Value = the measure
+    std::vector<MeasureEntry> measureEntries;
+
+    //Key = (codename ID, label) | Value = measure index
+    std::map<std::pair<SymbolID, std::string>, std::uint32_t> measureIndexes;
+
+    //the last measure looked up, as rows for a measure usually come together
+    std::string lastCodename;
+    std::string lastLabel;
+    std::uint32_t lastMeasure = 0;
+    bool hasLastMeasure = false;
+
+    //the columns: Index = row
+    std::vector<SymbolID> areaColumn;
+    std::vector<std::uint32_t> measureColumn;
+    std::vector<unsigned int> yearColumn;
+    std::vector<double> valueColumn;
+    std::vector<std::uint8_t> flagColumn;
+
+public:
+    /*----Ingest----*/
+    bool addArea(SymbolID area);
+    void setName(SymbolID area, SymbolID lang, std::string name);
+    std::uint32_t measure(std::string_view codename, std::string_view label);
+    void addRow(SymbolID area, std::uint32_t measure, unsigned int year, double value, std::uint8_t flags);
+    void append(ColumnStore&& other, bool replaceNames);
+
+    /*----Scans----*/
+    std::size_t size() const;
+    std::size_t areaCount() const;
+    const std::vector<SymbolID>& areas() const;
+    const std::vector<std::uint32_t>& measures() const;
+    const std::vector<unsigned int>& years() const;
+    const std::vector<double>& values() const;
+    const std::vector<std::uint8_t>& flags() const;
+    const MeasureEntry& getMeasure(std::uint32_t measure) const;
+
+    /*----Views----*/
+    template<class Container>
+    void applyTo(Container& areas, std::size_t fromRow, std::size_t fromArea) const;
+    template<class Container>
+    void applyNamesTo(Container& areas) const;
+
+    /*----Miscellaneous----*/
+    void clear();
+};
+
+/*
+  Build (or bring up to date) Area and Measure objects from the store. The
+  areas in the dictionary from fromArea onwards are added to areas, and
+  those new to the container take the names in the dictionary (an Area that
+  is already there, e.g. from Areas::setArea(), keeps its names; see
+  applyNamesTo()). Then the rows from fromRow onwards are applied in order.
+  Applying the store in several calls, each starting where the last stopped,
+  gives the same objects as applying it all at once.
+
+  Consecutive rows for the same area and measure (e.g. a row of an
+  AuthorityByYearCSV file) are applied to the same Measure, which is only
+  looked up (or replaced) once.
+
+  @param areas
+    The container to build the objects in (an AreasContainer)
+
+  @param fromRow
+    The first row to apply
+
+  @param fromArea
+    The first area of the dictionary to add, in the order they were added
+    (i.e. areaCount() when the store was last applied)
+
+  @example
+    AreasContainer areas;
+    columns.applyTo(areas, 0, 0);
+*/
+template<class Container>
+void ColumnStore::applyTo(Container& areas, std::size_t fromRow, std::size_t fromArea) const {
+    for(auto names = areaNames.begin() + fromArea; names != areaNames.end(); ++names) {
+        auto found = areas.try_emplace(names->first);
+        if(!found.second)
+            continue;
+        Area& area = found.first->second;
+        area.localAuthorityCode = names->first;
+        for(auto const& name : names->second)
+            area.names[name.first] = name.second;
+    }
+
+    //a reading is applied as Area::setMeasure() applies a Measure with one
+    //reading: the codename and label are replaced, and the value is set
+    Measure* measure = nullptr;
+    for(std::size_t row = fromRow; row < size(); row++) {
+        const MeasureEntry& entry = measureEntries[measureColumn[row]];
+        bool sameMeasure = measure != nullptr && !(flagColumn[row] & REPLACE) &&
+                           areaColumn[row] == areaColumn[row - 1] &&
+                           measureColumn[row] == measureColumn[row - 1];
+
+        if(!sameMeasure) {
+            Area& area = areas[areaColumn[row]];
+            auto found = area.measures.find(entry.key);
+            if(found == area.measures.end() || (flagColumn[row] & REPLACE)) {
+                measure = &(area.measures[entry.key] = Measure(area.measures.get_allocator()));
+            }else{
+                measure = &found->second;
+            }
+            measure->codename = entry.codename;
+            measure->label = entry.label;
+        }
+
+        if(flagColumn[row] & HAS_VALUE)
+            measure->setValue(yearColumn[row], valueColumn[row]);
+    }
+}
+
+/*
+  Replace the names of the Areas already in a container with the names in
+  the dictionary, as Areas::setArea() would. Areas that are not in the
+  container are left for applyTo() to add.
+
+  @param areas
+    The container of Areas to rename (an AreasContainer)
+
+  @example
+    batch.applyNamesTo(areas);
+    batch.applyTo(areas, 0, 0);
+*/
+template<class Container>
+void ColumnStore::applyNamesTo(Container& areas) const {
+    for(auto const& names : areaNames) {
+        auto found = areas.find(names.first);
+        if(found == areas.end())
+            continue;
+        for(auto const& name : names.second)
+            found->second.names[name.first] = name.second;
+    }
+}
+
+#endif // COLUMNS_H_
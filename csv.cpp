@@ -0,0 +1,434 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the CSVBlockIndex and CSVTokenizer
+  classes. The text is only ever read once: each call to nextField() starts
+  where the last one finished. See the header file for additional comments.
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "csv.h"
+
+//the AVX2 classifier is built if the compiler targets AVX2, or can build a
+//single function for it and check for it at run time
+#if defined(__AVX2__)
+#define CSV_AVX2
+#define CSV_AVX2_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSV_AVX2
+#define CSV_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+/*
+  Classify up to a block of bytes a byte at a time.
+
+  @param p
+    The first byte
+
+  @param size
+    The number of bytes, at most CSVBlockIndex::BLOCK_SIZE
+
+  @return
+    The bitmasks of the bytes
+*/
+static CSVBlockIndex::Masks classifyScalar(const char* p, std::size_t size) noexcept {
+    CSVBlockIndex::Masks masks;
+    for(std::size_t i = 0; i < size; i++) {
+        const std::uint64_t bit = std::uint64_t(1) << i;
+        if(p[i] == ',')
+            masks.commas |= bit;
+        else if(p[i] == '"')
+            masks.quotes |= bit;
+        else if(p[i] == '\n' || p[i] == '\r')
+            masks.newlines |= bit;
+    }
+    return masks;
+}
+
+#if defined(__SSE2__)
+/*
+  Classify a whole block of bytes 16 at a time with SSE2.
+
+  @param p
+    The first byte of the block
+
+  @return
+    The bitmasks of the block
+*/
+static CSVBlockIndex::Masks classifySSE2(const char* p) noexcept {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    CSVBlockIndex::Masks masks;
+    for(unsigned int i = 0; i < CSVBlockIndex::BLOCK_SIZE; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i newline = _mm_or_si128(_mm_cmpeq_epi8(bytes, lf), _mm_cmpeq_epi8(bytes, cr));
+        masks.commas |= std::uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma))) << i;
+        masks.quotes |= std::uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote))) << i;
+        masks.newlines |= std::uint64_t(_mm_movemask_epi8(newline)) << i;
+    }
+    return masks;
+}
+#endif
+
+#if defined(CSV_AVX2)
+/*
+  Classify a whole block of bytes 32 at a time with AVX2. Only called if the
+  CPU has AVX2.
+
+  @param p
+    The first byte of the block
+
+  @return
+    The bitmasks of the block
+*/
+CSV_AVX2_TARGET
+static CSVBlockIndex::Masks classifyAVX2(const char* p) noexcept {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+
+    CSVBlockIndex::Masks masks;
+    for(unsigned int i = 0; i < CSVBlockIndex::BLOCK_SIZE; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i newline = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, lf), _mm256_cmpeq_epi8(bytes, cr));
+        masks.commas |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, comma)))) << i;
+        masks.quotes |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, quote)))) << i;
+        masks.newlines |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(newline))) << i;
+    }
+    return masks;
+}
+#endif
+
+/*
+  Classify a whole block of bytes with the fastest classifier the CPU can
+  run, which is chosen the first time this is called.
+
+  @param p
+    The first byte of the block
+
+  @return
+    The bitmasks of the block
+*/
+static CSVBlockIndex::Masks classifyBlock(const char* p) noexcept {
+    using Classifier = CSVBlockIndex::Masks (*)(const char*);
+    static const Classifier classifier = []() -> Classifier {
+#if defined(__AVX2__)
+        return classifyAVX2;
+#else
+#if defined(CSV_AVX2)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return classifyAVX2;
+#endif
+#if defined(__SSE2__)
+        return classifySSE2;
+#else
+        return [](const char* block) { return classifyScalar(block, CSVBlockIndex::BLOCK_SIZE); };
+#endif
+#endif
+    }();
+    return classifier(p);
+}
+
+/*
+  Construct an index of some CSV text. The text is not copied, so it must
+  outlive the index. Nothing is classified until the first search.
+
+  @param input
+    The CSV text
+
+  @example
+    CSVBlockIndex index("a,b\nc,d");
+*/
+CSVBlockIndex::CSVBlockIndex(std::string_view input)
+    : input(input), blockStart(std::string_view::npos) {}
+
+/*
+  Classify the block of the text starting at a position. The last block of
+  the text may be shorter than BLOCK_SIZE.
+
+  @param start
+    The start of the block, a multiple of BLOCK_SIZE
+*/
+void CSVBlockIndex::classify(std::size_t start) {
+    const std::size_t size = input.size() - start;
+    masks = size >= BLOCK_SIZE ? classifyBlock(input.data() + start)
+                               : classifyScalar(input.data() + start, size);
+    blockStart = start;
+}
+
+/*
+  Find the next structural character of the kinds asked for. Searches should
+  move forwards through the text, as each block is only classified again if
+  the search moves back into an earlier one.
+
+  @param from
+    The position to search from
+
+  @param kinds
+    The kinds of character to search for: COMMAS, QUOTES and/or NEWLINES
+
+  @return
+    The position of the first such character at or after from, or
+    std::string_view::npos if there is none
+
+  @example
+    CSVBlockIndex index("a,\"b\"\n");
+    index.find(0, CSVBlockIndex::COMMAS | CSVBlockIndex::NEWLINES); // 1
+    index.find(2, CSVBlockIndex::NEWLINES); // 5
+*/
+std::size_t CSVBlockIndex::find(std::size_t from, unsigned int kinds) {
+    while(from < input.size()) {
+        const std::size_t start = from - from % BLOCK_SIZE;
+        if(start != blockStart)
+            classify(start);
+
+        std::uint64_t mask = ((kinds & COMMAS) ? masks.commas : 0) |
+                             ((kinds & QUOTES) ? masks.quotes : 0) |
+                             ((kinds & NEWLINES) ? masks.newlines : 0);
+        mask &= ~std::uint64_t(0) << (from - start);
+        if(mask != 0)
+            return start + __builtin_ctzll(mask);
+
+        from = start + BLOCK_SIZE;
+    }
+    return std::string_view::npos;
+}
+
+/*
+  Construct a tokenizer for some CSV text. The text is not copied, so it must
+  outlive the tokenizer. The tokenizer starts before the first row, so call
+  nextRow() before reading any fields.
+
+  @param input
+    The CSV text, which can be a single line or a whole file
+
+  @example
+    CSVTokenizer csv("give,me,100%,please");
+*/
+CSVTokenizer::CSVTokenizer(std::string_view input)
+    : input(input), pos(0), index(input), rowOpen(false) {}
+
+/*
+  Move to the start of the next row, skipping any fields left unread in the
+  current row. Unread fields are not split up: unless one of them is quoted
+  (and so might hold a line break), the rest of the row is skipped by
+  searching for the end of the line.
+
+  @return
+    true if there is another row, false at the end of the text
+
+  @example
+    CSVTokenizer csv("a,b\nc,d");
+    while(csv.nextRow()) {
+      ...
+    }
+*/
+bool CSVTokenizer::nextRow() {
+    std::string_view skipped;
+    while(rowOpen) {
+        std::size_t end = index.find(pos, CSVBlockIndex::QUOTES | CSVBlockIndex::NEWLINES);
+        if(end == std::string_view::npos || input[end] != '"') {
+            endField(end == std::string_view::npos ? input.size() : end);
+            break;
+        }
+        nextField(skipped);
+    }
+
+    if(pos >= input.size())
+        return false;
+
+    rowOpen = true;
+    return true;
+}
+
+/*
+  Read the next field in the current row.
+
+  @param field
+    Set to the contents of the field, without any surrounding quotes
+
+  @return
+    true if a field was read, false if there are no more fields in this row
+
+  @throws
+    std::runtime_error if a quoted field is not closed, or is followed by
+    something other than a comma or the end of the row
+
+  @example
+    CSVTokenizer csv("give,me,\"100%, please\"");
+    csv.nextRow();
+
+    std::string_view field;
+    csv.nextField(field); // field == "give"
+    csv.nextField(field); // field == "me"
+    csv.nextField(field); // field == "100%, please"
+*/
+bool CSVTokenizer::nextField(std::string_view& field) {
+    if(!rowOpen)
+        return false;
+
+    const std::size_t size = input.size();
+
+    if(pos < size && input[pos] == '"') {
+        std::size_t start = pos + 1;
+        std::size_t close = index.find(start, CSVBlockIndex::QUOTES);
+
+        //a pair of quotes is an escaped quote, not the end of the field
+        bool escaped = false;
+        while(close != std::string_view::npos && close + 1 < size && input[close + 1] == '"') {
+            escaped = true;
+            close = index.find(close + 2, CSVBlockIndex::QUOTES);
+        }
+
+        if(close == std::string_view::npos)
+            throw std::runtime_error("CSVTokenizer: Unterminated quoted field");
+
+        if(escaped) {
+            unescaped.clear();
+            for(std::size_t i = start; i < close; i++) {
+                unescaped += input[i];
+                if(input[i] == '"')
+                    i++;
+            }
+            field = unescaped;
+        }else{
+            field = input.substr(start, close - start);
+        }
+
+        std::size_t end = close + 1;
+        if(end < size && input[end] != ',' && input[end] != '\n' && input[end] != '\r')
+            throw std::runtime_error("CSVTokenizer: Unexpected character after quoted field");
+        endField(end);
+    }else{
+        std::size_t end = index.find(pos, CSVBlockIndex::COMMAS | CSVBlockIndex::NEWLINES);
+        if(end == std::string_view::npos)
+            end = size;
+
+        field = input.substr(pos, end - pos);
+        endField(end);
+    }
+
+    return true;
+}
+
+/*
+  Step over the delimiter that ends a field, noting if it also ended the row.
+
+  @param end
+    The position of the delimiter (or the end of the text)
+*/
+void CSVTokenizer::endField(std::size_t end) {
+    const std::size_t size = input.size();
+
+    if(end >= size) {
+        pos = size;
+        rowOpen = false;
+    }else if(input[end] == ',') {
+        pos = end + 1;
+    }else{
+        //\r\n counts as a single line ending
+        pos = end + 1;
+        if(input[end] == '\r' && pos < size && input[pos] == '\n')
+            pos++;
+        rowOpen = false;
+    }
+}
+
+/*
+  The position in the text of the next unread character. Once every field of
+  a row has been read, this is the start of the next row.
+
+  @return
+    The offset of the next unread character from the start of the text
+
+  @example
+    CSVTokenizer csv("a,b\nc,d");
+    std::string_view field;
+    csv.nextRow();
+    while(csv.nextField(field)) {}
+    csv.position(); // 4
+*/
+std::size_t CSVTokenizer::position() const noexcept {
+    return pos;
+}
+
+/*
+  Find where to split some CSV text into ranges of whole rows of roughly the
+  same size, so that each range can be read by a tokenizer of its own. Each
+  split is just after a \n that follows an even number of quotes from the
+  start of the rows, i.e. one that is not inside a quoted field.
+
+  A quote in the middle of an unquoted field (which the tokenizer reads as
+  an ordinary character) upsets the count, so a split can still land inside
+  a quoted field. The range before such a split ends part way through the
+  field, and reading it throws std::runtime_error.
+
+  @param input
+    The CSV text
+
+  @param from
+    The start of the first row to split (e.g. just after a header row)
+
+  @param parts
+    The number of ranges wanted
+
+  @return
+    The start of each range after the first, in order, which is fewer than
+    parts - 1 if there are not enough rows to split between
+
+  @example
+    auto splits = CSVTokenizer::splitRows(buffer, csv.position(), 4);
+*/
+std::vector<std::size_t> CSVTokenizer::splitRows(std::string_view input,
+                                                 std::size_t from,
+                                                 std::size_t parts) {
+    std::vector<std::size_t> splits;
+    if(from >= input.size())
+        return splits;
+
+    //the number of quotes between from and counted
+    std::size_t quotes = 0;
+    std::size_t counted = from;
+
+    for(std::size_t part = 1; part < parts; part++) {
+        std::size_t target = from + (input.size() - from) / parts * part;
+        if(target > counted) {
+            quotes += std::count(input.begin() + counted, input.begin() + target, '"');
+            counted = target;
+        }
+
+        //the split is after the next \n outside quotes
+        std::size_t split = std::string_view::npos;
+        while(split == std::string_view::npos) {
+            std::size_t found = input.find_first_of("\"\n", counted);
+            if(found == std::string_view::npos)
+                return splits;
+            counted = found + 1;
+            if(input[found] == '"')
+                quotes++;
+            else if(quotes % 2 == 0)
+                split = counted;
+        }
+
+        if(split >= input.size())
+            break;
+        splits.push_back(split);
+    }
+
+    return splits;
+}
@@ -0,0 +1,123 @@
+#ifndef CSV_H_
+#define CSV_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the CSVTokenizer class, which splits
+  comma-separated values (as described in RFC 4180) into rows and fields
+  without copying them, and of the CSVBlockIndex class it finds commas,
+  quotes and line endings with.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+  A CSVBlockIndex finds the characters that give CSV text its structure:
+  commas, quotes and line endings (\n and \r). The text is split into blocks
+  of 64 bytes, and each block is classified once into a bitmask for each kind
+  of character, bit i being set if byte i of the block is one. Finding the
+  next structural character is then a matter of clearing the bits before the
+  position and counting trailing zeros, so a search through a short field
+  costs a few instructions rather than a comparison of every byte.
+
+  Blocks are classified 32 bytes at a time with AVX2 if the CPU has it (found
+  out at run time), 16 bytes at a time with SSE2 otherwise, or a byte at a
+  time where neither is available and for the last part of the text.
+*/
+class CSVBlockIndex {
+public:
+    //the kinds of character find() can search for, combined with |
+    static const unsigned int COMMAS = 1;
+    static const unsigned int QUOTES = 2;
+    static const unsigned int NEWLINES = 4;
+
+    static const std::size_t BLOCK_SIZE = 64;
+
+    /*
+      The bitmasks of a block, one for each kind of character.
+    */
+    struct Masks {
+        std::uint64_t commas = 0;
+        std::uint64_t quotes = 0;
+        std::uint64_t newlines = 0;
+    };
+
+private:
+    //the text being indexed
+    std::string_view input;
+
+    //the start of the block classified last, and its bitmasks
+    std::size_t blockStart;
+    Masks masks;
+
+    void classify(std::size_t start);
+
+public:
+  /*----Constructor----*/
+  explicit CSVBlockIndex(std::string_view input);
+
+  /*----Searching----*/
+  std::size_t find(std::size_t from, unsigned int kinds);
+};
+
+/*
+  A CSVTokenizer walks over a block of CSV text once, from start to end,
+  handing back each field as a std::string_view into the original text.
+
+  Fields may be quoted with double quotes, in which case they can contain
+  commas, new lines and escaped quotes (""). Rows can end with \n or \r\n.
+
+  Views returned for fields without escaped quotes point into the original
+  text, so they remain valid for as long as the text does. Views for fields
+  with escaped quotes point into the tokenizer and are only valid until the
+  next call to nextField() or nextRow().
+
+  The end of each field is found with a CSVBlockIndex over the text.
+
+  A large file can be split by several tokenizers at once: splitRows() finds
+  row boundaries, and each tokenizer is given the text between two of them.
+*/
+class CSVTokenizer {
+private:
+    //the text being split
+    std::string_view input;
+
+    //position of the next unread character
+    std::size_t pos;
+
+    //where the commas, quotes and line endings are
+    CSVBlockIndex index;
+
+    //true while there are unread fields left in the current row
+    bool rowOpen;
+
+    //buffer for quoted fields that had to be unescaped
+    std::string unescaped;
+
+    void endField(std::size_t end);
+
+public:
+  /*----Constructor----*/
+  CSVTokenizer(std::string_view input);
+
+  /*----Reading----*/
+  bool nextRow();
+  bool nextField(std::string_view& field) noexcept(false);
+  std::size_t position() const noexcept;
+
+  /*----Ranges----*/
+  static std::vector<std::size_t> splitRows(std::string_view input,
+                                            std::size_t from,
+                                            std::size_t parts);
+};
+
+#endif // CSV_H_
@@ -0,0 +1,105 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  The entry point for bethyw-generate, which fills a directory with synthetic
+  copies of areas.csv and every dataset in datasets.h (see DatasetGenerator).
+  The directory can then be read with bethyw --dir. Build and run with:
+
+    ./build.sh generate
+    ./bin/bethyw-generate --dir generated --areas 1000 --measures 50 --years 100
+    ./bin/bethyw --dir generated -j
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib_cxxopts.hpp"
+
+#include "datasets.h"
+#include "generator.h"
+
+int main(int argc, char *argv[]) {
+  cxxopts::Options cxxopts(
+        "bethyw-generate",
+        "Generate synthetic StatsWales datasets for testing Beth Yw? at scale.\n");
+
+  cxxopts.add_options()(
+      "dir",
+      "Directory to write the datasets to (created if needed)",
+      cxxopts::value<std::string>()->default_value("generated"))(
+
+      "a,areas",
+      "The number of areas",
+      cxxopts::value<unsigned int>()->default_value("22"))(
+
+      "m,measures",
+      "The number of measures in datasets with more than one",
+      cxxopts::value<unsigned int>()->default_value("3"))(
+
+      "y,years",
+      "The number of years, ending at 2020",
+      cxxopts::value<unsigned int>()->default_value("30"))(
+
+      "s,seed",
+      "The seed for the generated values",
+      cxxopts::value<unsigned long long>()->default_value("1"))(
+
+      "h,help",
+      "Print usage.");
+
+  try {
+    auto args = cxxopts.parse(argc, argv);
+    if (args.count("help")) {
+      std::cerr << cxxopts.help() << std::endl;
+      return 0;
+    }
+
+    std::string dir = args["dir"].as<std::string>();
+    std::filesystem::create_directories(dir);
+
+    std::vector<BethYw::InputFileSource> sources = {BethYw::InputFiles::AREAS};
+    for (auto const &dataset : BethYw::InputFiles::DATASETS)
+      sources.push_back(dataset);
+
+    // A large buffer, as the files can be many gigabytes
+    std::unique_ptr<char[]> buffer(new char[1 << 20]);
+
+    for (std::size_t i = 0; i < sources.size(); i++) {
+      auto const &source = sources[i];
+
+      // Each file has its own seed, so the datasets do not all hold the
+      // same values
+      DatasetGenerator generator(args["areas"].as<unsigned int>(),
+                                 args["measures"].as<unsigned int>(),
+                                 args["years"].as<unsigned int>(),
+                                 args["seed"].as<unsigned long long>() + i);
+
+      auto path = std::filesystem::path(dir) / source.FILE;
+      std::ofstream file;
+      file.rdbuf()->pubsetbuf(buffer.get(), 1 << 20);
+      file.open(path, std::ios::binary | std::ios::trunc);
+      if (!file)
+        throw std::runtime_error("Failed to open file " + path.string());
+
+      generator.write(file, source);
+      file.close();
+      if (!file)
+        throw std::runtime_error("Failed to write file " + path.string());
+
+      std::cerr << path.string() << ": " << std::filesystem::file_size(path) << " bytes" << std::endl;
+    }
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
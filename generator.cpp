@@ -0,0 +1,255 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the DatasetGenerator class. See the
+  header file for additional comments.
+*/
+
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "generator.h"
+
+/*
+  Construct a generator for a given number of areas, measures and years.
+
+  @param areas
+    The number of areas (at most 100,000,000, as codes are W + 8 digits)
+
+  @param measures
+    The number of measures in datasets that have more than one
+
+  @param years
+    The number of years, ending at 2020 (at most 1021, as years must have four
+    digits)
+
+  @param seed
+    The seed for the pseudo-random values
+
+  @throws
+    std::invalid_argument if any of the numbers are out of range
+
+  @example
+    DatasetGenerator generator(22, 3, 20);
+*/
+DatasetGenerator::DatasetGenerator(unsigned int areas,
+                                   unsigned int measures,
+                                   unsigned int years,
+                                   std::uint64_t seed)
+    : numAreas(areas), numMeasures(measures), numYears(years), state(seed) {
+    if(areas == 0 || areas > 100000000)
+        throw std::invalid_argument("DatasetGenerator: Number of areas must be between 1 and 100000000");
+    if(measures == 0)
+        throw std::invalid_argument("DatasetGenerator: Number of measures must be at least 1");
+    if(years == 0 || years > 1021)
+        throw std::invalid_argument("DatasetGenerator: Number of years must be between 1 and 1021");
+
+    firstYear = 2021 - years;
+}
+
+/*
+  Write a file in the format of an InputFileSource from datasets.h.
+
+  @param os
+    The stream to write the file to
+
+  @param source
+    The dataset to write a file for, which decides the format and columns
+
+  @example
+    DatasetGenerator generator(22, 3, 20);
+    std::ofstream file("popu1009.json");
+    generator.write(file, BethYw::InputFiles::POPDEN);
+*/
+void DatasetGenerator::write(std::ostream& os, const BethYw::InputFileSource& source) {
+    switch(source.PARSER) {
+        case BethYw::AuthorityCodeCSV:   writeAuthorityCodeCSV(os, source.COLS); break;
+        case BethYw::WelshStatsJSON:     writeWelshStatsJSON(os, source.COLS); break;
+        case BethYw::AuthorityByYearCSV: writeAuthorityByYearCSV(os, source.COLS); break;
+        default:
+            throw std::runtime_error("DatasetGenerator::write: Unexpected data type");
+    }
+}
+
+/*
+  Write an areas.csv file, with a row for each area giving its English and
+  Welsh names.
+
+  @param os
+    The stream to write the file to
+
+  @param cols
+    The column names to use in the header row
+*/
+void DatasetGenerator::writeAuthorityCodeCSV(std::ostream& os, const BethYw::SourceColumnMapping& cols) {
+    os << cols.at(BethYw::AUTH_CODE) << ','
+       << cols.at(BethYw::AUTH_NAME_ENG) << ','
+       << cols.at(BethYw::AUTH_NAME_CYM) << '\n';
+
+    std::string row;
+    for(unsigned int area = 0; area < numAreas; area++) {
+        const std::string number = std::to_string(area + 1);
+        row = areaCode(area) + ",Area " + number + ",Ardal " + number + '\n';
+        os.write(row.data(), row.size());
+    }
+}
+
+/*
+  Write a WelshStatsJSON file, laid out like the files from StatsWales, with
+  a record in the "value" array for each area, measure and year. Each record
+  also has RowKey and PartitionKey fields, which Beth Yw? does not use.
+
+  @param os
+    The stream to write the file to
+
+  @param cols
+    The field names to use in each record. If there is a SINGLE_MEASURE_CODE
+    the records have no measure fields and only one measure is written.
+*/
+void DatasetGenerator::writeWelshStatsJSON(std::ostream& os, const BethYw::SourceColumnMapping& cols) {
+    const bool singleMeasure = cols.find(BethYw::SINGLE_MEASURE_CODE) != cols.end();
+    const unsigned int measures = singleMeasure ? 1 : numMeasures;
+
+    const std::string dataCol = "\"" + cols.at(BethYw::VALUE) + "\":";
+    const std::string codeCol = ",\"" + cols.at(BethYw::AUTH_CODE) + "\":\"";
+    const std::string nameCol = "\",\"" + cols.at(BethYw::AUTH_NAME_ENG) + "\":\"";
+    const std::string yearCol = "\",\"" + cols.at(BethYw::YEAR) + "\":\"";
+
+    //some datasets use the same field for the measure code and name
+    std::string measureCodeCol;
+    std::string measureNameCol;
+    if(!singleMeasure) {
+        measureCodeCol = "\",\"" + cols.at(BethYw::MEASURE_CODE) + "\":\"";
+        if(cols.at(BethYw::MEASURE_NAME) != cols.at(BethYw::MEASURE_CODE))
+            measureNameCol = "\",\"" + cols.at(BethYw::MEASURE_NAME) + "\":\"";
+    }
+
+    os << "{\n  \"odata.metadata\":\"generated\",\"value\":[\n";
+
+    std::string record;
+    char value[32];
+    std::uint64_t row = 0;
+    for(unsigned int area = 0; area < numAreas; area++) {
+        const std::string code = areaCode(area);
+        const std::string name = "Area " + std::to_string(area + 1);
+
+        for(unsigned int measure = 0; measure < measures; measure++) {
+            const std::string measureName = "Measure " + std::to_string(measure + 1);
+
+            for(unsigned int year = firstYear; year < firstYear + numYears; year++, row++) {
+                std::snprintf(value, sizeof(value), "%.6f", nextValue());
+
+                record = row == 0 ? "    {\n      " : "    },{\n      ";
+                record += dataCol;
+                record += value;
+                record += codeCol;
+                record += code;
+                record += nameCol;
+                record += name;
+                if(!singleMeasure) {
+                    record += measureCodeCol;
+                    record += measureCode(measure);
+                    if(!measureNameCol.empty()) {
+                        record += measureNameCol;
+                        record += measureName;
+                    }
+                }
+                record += yearCol;
+                record += std::to_string(year);
+
+                std::snprintf(value, sizeof(value), "%016llu", static_cast<unsigned long long>(row));
+                record += "\",\"RowKey\":\"";
+                record += value;
+                record += "\",\"PartitionKey\":\"\"\n";
+                os.write(record.data(), record.size());
+            }
+        }
+    }
+
+    os << (row == 0 ? "  ]\n}\n" : "    }\n  ]\n}\n");
+}
+
+/*
+  Write an AuthorityByYearCSV file, with a header row of years and then a row
+  of values for each area.
+
+  @param os
+    The stream to write the file to
+
+  @param cols
+    The column names to use (only AUTH_CODE is written to the file)
+*/
+void DatasetGenerator::writeAuthorityByYearCSV(std::ostream& os, const BethYw::SourceColumnMapping& cols) {
+    os << cols.at(BethYw::AUTH_CODE);
+    for(unsigned int year = firstYear; year < firstYear + numYears; year++)
+        os << ',' << year;
+    os << '\n';
+
+    std::string row;
+    char value[32];
+    for(unsigned int area = 0; area < numAreas; area++) {
+        row = areaCode(area);
+        for(unsigned int year = 0; year < numYears; year++) {
+            std::snprintf(value, sizeof(value), ",%.6f", nextValue());
+            row += value;
+        }
+        row += '\n';
+        os.write(row.data(), row.size());
+    }
+}
+
+/*
+  The local authority code used for an area: W followed by eight digits.
+
+  @param area
+    The number of the area, from 0
+
+  @return
+    The area's code
+
+  @example
+    DatasetGenerator::areaCode(11); // "W00000011"
+*/
+std::string DatasetGenerator::areaCode(unsigned int area) {
+    char code[16];
+    std::snprintf(code, sizeof(code), "W%08u", area);
+    return code;
+}
+
+/*
+  The code used for a measure: M followed by its number.
+
+  @param measure
+    The number of the measure, from 0
+
+  @return
+    The measure's code
+
+  @example
+    DatasetGenerator::measureCode(0); // "M1"
+*/
+std::string DatasetGenerator::measureCode(unsigned int measure) {
+    return "M" + std::to_string(measure + 1);
+}
+
+/*
+  Generate the next pseudo-random value, between 0 and 100,000. This uses
+  SplitMix64 rather than <random>, so the values are the same with every
+  compiler and standard library.
+
+  @return
+    The next value
+*/
+double DatasetGenerator::nextValue() {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+    return (z >> 11) * (100000.0 / 9007199254740992.0);
+}
@@ -0,0 +1,72 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the DatasetGenerator class, which
+  writes made up data in the same formats as the files in the datasets
+  directory, so Beth Yw? can be tested on much larger inputs.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "datasets.h"
+
+/*
+  A DatasetGenerator writes synthetic areas.csv, WelshStatsJSON and
+  AuthorityByYearCSV files, using the column names from an InputFileSource in
+  datasets.h, so the files can be read by Areas::populate() with that
+  dataset's COLS.
+
+  The size of each file is set by the number of areas, measures and years:
+    - areas.csv has a row for each area
+    - a WelshStatsJSON file has a record for each area, measure and year (only
+      one measure if the dataset uses SINGLE_MEASURE_CODE)
+    - an AuthorityByYearCSV file has a row for each area and a column for each
+      year
+
+  The years always end at 2020, the last year BethYw::validateYear() accepts.
+  The values are pseudo-random but repeatable: the same seed always gives the
+  same files. Files are written as they are generated, so they can be far
+  larger than the memory available.
+*/
+class DatasetGenerator {
+private:
+    unsigned int numAreas;
+    unsigned int numMeasures;
+    unsigned int numYears;
+
+    //the first year of data
+    unsigned int firstYear;
+
+    //state for the pseudo-random values
+    std::uint64_t state;
+
+    double nextValue();
+
+public:
+  /*----Constructor----*/
+  DatasetGenerator(unsigned int areas,
+                   unsigned int measures,
+                   unsigned int years,
+                   std::uint64_t seed = 1) noexcept(false);
+
+  /*----Writing----*/
+  void write(std::ostream& os, const BethYw::InputFileSource& source);
+  void writeAuthorityCodeCSV(std::ostream& os, const BethYw::SourceColumnMapping& cols);
+  void writeWelshStatsJSON(std::ostream& os, const BethYw::SourceColumnMapping& cols);
+  void writeAuthorityByYearCSV(std::ostream& os, const BethYw::SourceColumnMapping& cols);
+
+  /*----Helpers----*/
+  static std::string areaCode(unsigned int area);
+  static std::string measureCode(unsigned int measure);
+};
+
+#endif // GENERATOR_H_
@@ -13,7 +13,16 @@
  */
 
 #include "input.h"
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /*
   Constructor for an InputSource.
@@ -64,4 +73,298 @@ std::istream& InputFile::open(){
             throw std::runtime_error("InputFile::open: Failed to open file " + InputFile::getSource());
     }
     return *fileStream;
-}
\ No newline at end of file
+}
+
+/*
+  Construct a stream buffer over a block of memory. The memory is not copied,
+  so it must outlive the buffer.
+
+  @param bytes
+    The block of memory to read from
+
+  @example
+    MemoryBuffer buffer(std::string_view("a,b,c"));
+    std::istream stream(&buffer);
+*/
+MemoryBuffer::MemoryBuffer(std::string_view bytes) {
+    //std::streambuf only deals in mutable pointers, but nothing here writes
+    char* start = const_cast<char*>(bytes.data());
+    setg(start, start, start + bytes.size());
+}
+
+/*
+  Move the read position relative to the start, current position or end of
+  the memory block. Called by std::istream::seekg() and tellg().
+
+  @return
+    The new position, or -1 if it would be outside of the block
+*/
+MemoryBuffer::pos_type MemoryBuffer::seekoff(off_type off,
+                                             std::ios_base::seekdir dir,
+                                             std::ios_base::openmode which) {
+    if(!(which & std::ios_base::in))
+        return pos_type(off_type(-1));
+
+    off_type base = 0;
+    if(dir == std::ios_base::cur)
+        base = gptr() - eback();
+    else if(dir == std::ios_base::end)
+        base = egptr() - eback();
+
+    off_type target = base + off;
+    if(target < 0 || target > egptr() - eback())
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + target, egptr());
+    return pos_type(target);
+}
+
+/*
+  Move the read position to an absolute offset in the memory block.
+
+  @return
+    The new position, or -1 if it would be outside of the block
+*/
+MemoryBuffer::pos_type MemoryBuffer::seekpos(pos_type pos,
+                                             std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/*
+  Constructor for a memory-mapped file source. The file is not touched until
+  open() is called.
+
+  @param filePath
+    The complete path for a file to import.
+
+  @example
+    MappedInputFile input("data/popu1009.json");
+*/
+MappedInputFile::MappedInputFile(const std::string& filePath)
+    : InputSource(filePath), data(nullptr), length(0), mapped(false) {}
+
+/*
+  Unmap the file (if it was mapped). Any views returned by open() or view()
+  are no longer valid after this.
+*/
+MappedInputFile::~MappedInputFile() {
+#ifndef _WIN32
+    if(data != nullptr)
+        munmap(const_cast<char*>(data), length);
+#endif
+}
+
+/*
+  Map the file at the path retrievable from getSource() into memory, and
+  return a read-only view of all of its bytes. Calling this more than once
+  returns the same view.
+
+  @return
+    A view of the file's contents
+
+  @throws
+    std::runtime_error if there is an issue opening the file, with the message:
+    MappedInputFile::open: Failed to open file <file name>
+
+  @example
+    MappedInputFile input("data/popu1009.json");
+    std::string_view bytes = input.open();
+*/
+std::string_view MappedInputFile::open() {
+    if(mapped)
+        return view();
+
+    const std::string error = "MappedInputFile::open: Failed to open file " + getSource();
+
+#ifdef _WIN32
+    std::ifstream file(getSource(), std::ios::binary);
+    if(!file.good())
+        throw std::runtime_error(error);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = contents.data();
+    length = contents.size();
+#else
+    int fd = ::open(getSource().c_str(), O_RDONLY);
+    if(fd == -1)
+        throw std::runtime_error(error);
+
+    struct stat info;
+    if(fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        throw std::runtime_error(error);
+    }
+
+    //mmap() will not map zero bytes, but an empty file is still a valid file
+    if(info.st_size > 0) {
+        void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error(error);
+        }
+        //we read the file from start to end, so let the kernel read ahead
+        madvise(address, info.st_size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(address);
+        length = info.st_size;
+    }
+    //the mapping holds its own reference to the file
+    close(fd);
+#endif
+
+    mapped = true;
+    return view();
+}
+
+/*
+  Map the file (if it has not been already) and return a standard input
+  stream that reads straight from the mapped bytes. This is for parsers that
+  can only read from a stream.
+
+  @return
+    A standard input stream reference, valid for the lifetime of this object
+
+  @throws
+    std::runtime_error if there is an issue opening the file, see open()
+
+  @example
+    MappedInputFile input("data/areas.csv");
+    std::istream& is = input.openStream();
+*/
+std::istream& MappedInputFile::openStream() {
+    if(!stream) {
+        buffer.reset(new MemoryBuffer(open()));
+        stream.reset(new std::istream(buffer.get()));
+    }
+    return *stream;
+}
+
+/*
+  Retrieve the view of the mapped bytes. This function is callable from a
+  constant context, and returns an empty view if open() has not been called.
+
+  @return
+    A read-only view of the file's contents
+
+  @example
+    MappedInputFile input("data/areas.csv");
+    input.open();
+    auto size = input.view().size();
+*/
+std::string_view MappedInputFile::view() const {
+    return std::string_view(data, length);
+}
+
+/*
+  Start reading a list of files on a background thread. The first depth
+  files are read straight away.
+
+  @param paths
+    The complete paths of the files, in the order they will be opened
+
+  @param depth
+    The number of files after the last one opened that may be read (at
+    least 1)
+
+  @example
+    ReadAhead readAhead({"data/popu1009.json", "data/econ0080.json"});
+    for(std::size_t i = 0; i < 2; i++) {
+      readAhead.opening(i);
+      ...
+    }
+*/
+ReadAhead::ReadAhead(std::vector<std::string> paths, std::size_t depth)
+    : paths(std::move(paths)), depth(std::max<std::size_t>(depth, 1)) {
+    thread = std::thread(&ReadAhead::run, this);
+}
+
+/*
+  Stop reading (part way through a file if need be) and wait for the
+  background thread to finish.
+*/
+ReadAhead::~ReadAhead() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+/*
+  Say that a file in the list is being opened, which lets the thread read up
+  to depth files past it. Files before it that have not been read yet are
+  no longer worth reading, and are skipped.
+
+  @param index
+    The index of the file in the list given to the constructor
+
+  @example
+    readAhead.opening(i);
+    MappedInputFile input(paths[i]);
+    input.open();
+*/
+void ReadAhead::opening(std::size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = std::max(opened, index + 1);
+    }
+    changed.notify_all();
+}
+
+/*
+  The background thread: read each file once it is within depth files of
+  the last one opened, and skip any the caller has already got to.
+*/
+void ReadAhead::run() {
+    for(std::size_t i = 0; i < paths.size(); i++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return stopping || i < opened + depth; });
+            if(stopping)
+                return;
+            if(i + 1 < opened)
+                continue;
+        }
+        readFile(paths[i]);
+    }
+}
+
+/*
+  Check if the thread has been asked to stop.
+
+  @return
+    true if the destructor has been called
+*/
+bool ReadAhead::stopped() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stopping;
+}
+
+/*
+  Read a whole file, throwing the bytes away, so that it is in the page
+  cache. Reading stops early if the thread is asked to stop, and a file that
+  cannot be opened is skipped.
+
+  @param path
+    The complete path of the file
+*/
+void ReadAhead::readFile(const std::string& path) {
+    //big enough that a network file system gets large requests
+    std::vector<char> chunk(1 << 20);
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    while(file.good() && !stopped())
+        file.read(chunk.data(), chunk.size());
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd == -1)
+        return;
+
+#ifdef POSIX_FADV_WILLNEED
+    //ask for the whole file at once, as well as reading it below
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    while(!stopped() && ::read(fd, chunk.data(), chunk.size()) > 0) {}
+    close(fd);
+#endif
+}
@@ -9,9 +9,13 @@
   AUTHOR: 976789
 
   This file contains declarations for the input source handlers. There are
-  two classes: InputSource and InputFile. InputSource is abstract (i.e. it
-  contains a pure virtual function). InputFile is a concrete derivation of
-  InputSource, for input from files.
+  three classes: InputSource, InputFile and MappedInputFile. InputSource is
+  abstract (i.e. it contains a pure virtual function). InputFile is a concrete
+  derivation of InputSource, for input from files through a stream.
+  MappedInputFile is a concrete derivation of InputSource that maps a file
+  into memory and exposes the bytes directly, without copying them through a
+  stream first. ReadAhead reads the files that are about to be opened on a
+  background thread, so they are already in memory when they are.
 
   Although only one class derives from InputSource, we have implemented our
   code this way to support future expansion of input from different sources
@@ -21,8 +25,16 @@
   functions and member variables you need to declare in these classes.
  */
 
+#include <condition_variable>
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
 
 /*
   InputSource is an abstract/purely virtual base class for all input source 
@@ -53,4 +65,110 @@ public:
   std::istream& open() noexcept(false);
 };
 
+/*
+  A read-only stream buffer over a contiguous block of memory that is owned
+  by someone else. This lets code that expects a std::istream read directly
+  from a mapped file without the bytes being copied into a second buffer.
+*/
+class MemoryBuffer : public std::streambuf {
+public:
+  MemoryBuffer(std::string_view bytes);
+
+protected:
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+/*
+  Source data that is contained within a file, mapped into memory. The whole
+  file is available as a single contiguous read-only view of bytes that the
+  parsers in Areas can consume directly. The view remains valid for as long
+  as the MappedInputFile object exists.
+
+  On platforms without mmap() the file is read into memory once instead.
+*/
+class MappedInputFile : public InputSource {
+private:
+    //start of the mapped bytes (nullptr until open() is called)
+    const char* data;
+
+    //number of mapped bytes
+    std::size_t length;
+
+    //true once the file has been mapped (an empty file maps to no bytes)
+    bool mapped;
+
+#ifdef _WIN32
+    //the file contents, as there is no mmap() to map it with
+    std::string contents;
+#endif
+
+    //lazily created stream over the mapped bytes
+    std::unique_ptr<MemoryBuffer> buffer;
+    std::unique_ptr<std::istream> stream;
+
+public:
+  MappedInputFile(const std::string& filePath);
+  ~MappedInputFile();
+
+  MappedInputFile(const MappedInputFile&) = delete;
+  MappedInputFile& operator=(const MappedInputFile&) = delete;
+
+  std::string_view open() noexcept(false);
+  std::istream& openStream() noexcept(false);
+  std::string_view view() const;
+};
+
+/*
+  Reads a list of files, in order, on a background thread, so that by the
+  time each file is opened (e.g. by a MappedInputFile) its bytes are already
+  in the operating system's page cache. The reading happens while the file
+  before it is being parsed, which hides the time it takes to fetch a file
+  from a cold disk or a network file system.
+
+  The thread only reads a few files ahead of the last one the caller said it
+  is opening (see opening()), so files are not read so far ahead that they
+  have been dropped from the cache again before they are used. The bytes it
+  reads are thrown away. Files that cannot be read are skipped: the error is
+  left for whatever opens the file to report.
+
+  On POSIX systems, the kernel is also asked to start reading the whole file
+  at once with posix_fadvise().
+*/
+class ReadAhead {
+private:
+    //the files to read, in the order they will be opened
+    std::vector<std::string> paths;
+
+    //how many files after the last one opened may be read
+    std::size_t depth;
+
+    //the number of files the caller has started opening
+    std::size_t opened = 0;
+
+    //true once the thread should stop
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread thread;
+
+    void run();
+    void readFile(const std::string& path);
+    bool stopped();
+
+public:
+  /*----Constructor/Destructor----*/
+  ReadAhead(std::vector<std::string> paths, std::size_t depth = 2);
+  ~ReadAhead();
+
+  ReadAhead(const ReadAhead&) = delete;
+  ReadAhead& operator=(const ReadAhead&) = delete;
+
+  /*----Progress----*/
+  void opening(std::size_t index);
+};
+
 #endif // INPUT_H_
\ No newline at end of file
@@ -0,0 +1,200 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the JSONWriter class. See the
+  header file for additional comments.
+*/
+
+#include <array>
+#include <cmath>
+
+#include "jsonwriter.h"
+#include "lib_json.hpp"
+
+/*
+  Construct a writer for an output stream. Nothing is written until one of
+  the writing functions is called.
+
+  @param os
+    The stream to write to, which must outlive the writer
+
+  @example
+    JSONWriter writer(std::cout);
+*/
+JSONWriter::JSONWriter(std::ostream& os) : os(os), needComma(false) {}
+
+/*
+  Start a new object, either at the top level or as the value for the last
+  key written.
+
+  @example
+    JSONWriter writer(std::cout);
+    writer.beginObject();
+    writer.endObject(); // {}
+*/
+void JSONWriter::beginObject() {
+    separate();
+    os.put('{');
+    needComma = false;
+}
+
+/*
+  Finish the current object.
+*/
+void JSONWriter::endObject() {
+    os.put('}');
+    needComma = true;
+}
+
+/*
+  Start a new array, either at the top level, as the value for the last key
+  written, or as an element of the current array.
+
+  @example
+    JSONWriter writer(std::cout);
+    writer.beginArray();
+    writer.value(1.0);
+    writer.value(2.0);
+    writer.endArray(); // [1.0,2.0]
+*/
+void JSONWriter::beginArray() {
+    separate();
+    os.put('[');
+    needComma = false;
+}
+
+/*
+  Finish the current array.
+*/
+void JSONWriter::endArray() {
+    os.put(']');
+    needComma = true;
+}
+
+/*
+  Write the key for the next member of the current object. It must be
+  followed by a value or an object.
+
+  @param key
+    The key to write, which will be escaped if needed
+
+  @example
+    JSONWriter writer(std::cout);
+    writer.beginObject();
+    writer.key("2015");
+    writer.value(1.5);
+    writer.endObject(); // {"2015":1.5}
+*/
+void JSONWriter::key(std::string_view key) {
+    separate();
+    writeString(key);
+    os.put(':');
+    needComma = false;
+}
+
+/*
+  Write a string value.
+
+  @param value
+    The string to write, which will be escaped if needed
+*/
+void JSONWriter::value(std::string_view value) {
+    separate();
+    writeString(value);
+    needComma = true;
+}
+
+/*
+  Write a number value. Whole numbers are written with a trailing ".0" and
+  values that are not finite are written as null, as nlohmann::json does.
+
+  @param value
+    The number to write
+*/
+void JSONWriter::value(double value) {
+    if(!std::isfinite(value)) {
+        null();
+        return;
+    }
+
+    separate();
+    std::array<char, 64> buffer;
+    char* end = nlohmann::detail::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    os.write(buffer.data(), end - buffer.data());
+    needComma = true;
+}
+
+/*
+  Write a whole number value, without a decimal point.
+
+  @param value
+    The number to write
+*/
+void JSONWriter::value(std::uint64_t value) {
+    separate();
+    os << value;
+    needComma = true;
+}
+
+/*
+  Write a null value.
+*/
+void JSONWriter::null() {
+    separate();
+    os.write("null", 4);
+    needComma = true;
+}
+
+/*
+  Write a comma if the value about to be written is not the first in its
+  object or array. A value written straight after a key needs no comma, as
+  key() leaves needComma false.
+*/
+void JSONWriter::separate() {
+    if(needComma)
+        os.put(',');
+    needComma = false;
+}
+
+/*
+  Write a quoted string, escaping quotes, backslashes and control characters
+  the same way nlohmann::json does. Other characters are written unchanged.
+
+  @param str
+    The string to write
+*/
+void JSONWriter::writeString(std::string_view str) {
+    static const char hex[] = "0123456789abcdef";
+
+    os.put('"');
+    std::size_t run = 0;
+    for(std::size_t i = 0; i < str.size(); i++) {
+        const unsigned char c = str[i];
+        if(c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        //write the characters that needed no escaping in one go
+        os.write(str.data() + run, i - run);
+        run = i + 1;
+
+        switch(c) {
+            case '"':  os.write("\\\"", 2); break;
+            case '\\': os.write("\\\\", 2); break;
+            case '\b': os.write("\\b", 2); break;
+            case '\f': os.write("\\f", 2); break;
+            case '\n': os.write("\\n", 2); break;
+            case '\r': os.write("\\r", 2); break;
+            case '\t': os.write("\\t", 2); break;
+            default: {
+                const char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                os.write(escaped, sizeof(escaped));
+            }
+        }
+    }
+    os.write(str.data() + run, str.size() - run);
+    os.put('"');
+}
@@ -0,0 +1,56 @@
+#ifndef JSONWRITER_H_
+#define JSONWRITER_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the JSONWriter class, which writes
+  JSON text straight to an output stream as it is produced.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+
+/*
+  A JSONWriter writes objects, keys and values to a std::ostream in a single
+  pass, without building a json document first. Commas are added between
+  members and array elements automatically.
+
+  The text written is byte-for-byte what nlohmann::json::dump() gives for the
+  same document: compact, with numbers formatted the same way. Keys are
+  written in the order they are given, so callers must give them in sorted
+  order to match.
+*/
+class JSONWriter {
+private:
+    //the stream being written to
+    std::ostream& os;
+
+    //true if the next member or element needs a comma before it
+    bool needComma;
+
+    void separate();
+    void writeString(std::string_view str);
+
+public:
+  /*----Constructor----*/
+  JSONWriter(std::ostream& os);
+
+  /*----Writing----*/
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+  void key(std::string_view key);
+  void value(std::string_view value);
+  void value(double value);
+  void value(std::uint64_t value);
+  void null();
+};
+
+#endif // JSONWRITER_H_
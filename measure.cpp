@@ -14,8 +14,10 @@
 
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <numeric>
 #include <iomanip>
+#include <sstream>
 
 #include "measure.h"
 #include "bethyw.h"
@@ -27,6 +29,20 @@
 */
 using json = nlohmann::json;
 
+/*
+  Construct an empty Measure whose label and readings are allocated with a
+  given allocator. Containers of Measures (e.g. in Area) use this.
+
+  @param alloc
+    The allocator for the label and readings
+
+  @example
+    std::pmr::monotonic_buffer_resource arena;
+    Measure measure(Measure::allocator_type(&arena));
+*/
+Measure::Measure(const allocator_type& alloc)
+    : label(alloc), values(alloc), present(alloc) {}
+
 /*
   Construct a single Measure, that has values across many years.
 
@@ -39,20 +55,134 @@ using json = nlohmann::json;
   @param label
     Human-readable (i.e. nice/explanatory) label for the measure
 
+  @param alloc
+    The allocator for the label and readings (the default memory resource if
+    not given)
+
   @example
     std::string codename = "Pop";
     std::string label = "Population";
     Measure measure(codename, label);
 */
-Measure::Measure(std::string codename, const std::string &label) {
+Measure::Measure(std::string codename, const std::string &label, const allocator_type& alloc)
+    : label(alloc), values(alloc), present(alloc) {
     std::string temp;
     for(char& c : codename) {
        temp += std::tolower(c);
     }
-    this->codename = codename;
+    this->codename = SymbolTable::measures().intern(codename);
     this->label = label;
 }
 
+/*
+  Copy a Measure, allocating the copy's label and readings with a given
+  allocator. Copying a Measure into a container whose memory resource is
+  different (e.g. from a shard into Areas) uses this, so the copy never
+  points into the other container's memory.
+
+  @param other
+    The Measure to copy
+
+  @param alloc
+    The allocator for the copy
+
+  @example
+    Measure copy(measure, Measure::allocator_type(&arena));
+*/
+Measure::Measure(const Measure& other, const allocator_type& alloc)
+    : codename(other.codename),
+      label(other.label, alloc),
+      firstYear(other.firstYear),
+      values(other.values, alloc),
+      present(other.present, alloc),
+      count(other.count) {}
+
+/*
+  Move a Measure. The Measure moved from is left with no readings, so its
+  count and run of years agree with its (now empty) vectors.
+
+  @param other
+    The Measure to move from
+
+  @example
+    Measure moved(std::move(measure));
+*/
+Measure::Measure(Measure&& other) noexcept
+    : codename(other.codename),
+      label(std::move(other.label)),
+      firstYear(std::exchange(other.firstYear, 0)),
+      values(std::move(other.values)),
+      present(std::move(other.present)),
+      count(std::exchange(other.count, 0)) {}
+
+/*
+  Move a Measure, allocating the new Measure's label and readings with a given
+  allocator. If the allocators use the same memory resource the memory is
+  taken over, otherwise it is copied. Either way the Measure moved from is
+  left with no readings.
+
+  @param other
+    The Measure to move from
+
+  @param alloc
+    The allocator for the new Measure
+
+  @example
+    Measure moved(std::move(measure), Measure::allocator_type(&arena));
+*/
+Measure::Measure(Measure&& other, const allocator_type& alloc)
+    : codename(other.codename),
+      label(std::move(other.label), alloc),
+      firstYear(std::exchange(other.firstYear, 0)),
+      values(std::move(other.values), alloc),
+      present(std::move(other.present), alloc),
+      count(std::exchange(other.count, 0)) {
+    //with a different memory resource the vectors were copied, not emptied
+    other.values.clear();
+    other.present.clear();
+}
+
+/*
+  Move assign a Measure, keeping this Measure's allocator. The Measure moved
+  from is left with no readings, as with the move constructors.
+
+  @param other
+    The Measure to move from
+
+  @return
+    This Measure
+
+  @example
+    measure = Measure("Pop", "Population");
+*/
+Measure& Measure::operator=(Measure&& other) {
+    if(this == &other)
+        return *this;
+
+    codename = other.codename;
+    label = std::move(other.label);
+    firstYear = std::exchange(other.firstYear, 0);
+    values = std::move(other.values);
+    present = std::move(other.present);
+    count = std::exchange(other.count, 0);
+    other.values.clear();
+    other.present.clear();
+    return *this;
+}
+
+/*
+  Get the allocator the label and readings are allocated with.
+
+  @return
+    The allocator
+
+  @example
+    auto resource = measure.get_allocator().resource();
+*/
+Measure::allocator_type Measure::get_allocator() const {
+    return values.get_allocator();
+}
+
 /*
   Retrieve the code for the Measure. This function should be callable from a 
   constant context and must promise to not modify the state of the instance or 
@@ -71,7 +201,7 @@ Measure::Measure(std::string codename, const std::string &label) {
     auto codename2 = measure.getCodename();
 */
 const std::string Measure::getCodename() const{
-    return this->codename;
+    return SymbolTable::measures().name(this->codename);
 }
 
 /*
@@ -92,7 +222,7 @@ const std::string Measure::getCodename() const{
     auto label = measure.getLabel();
 */
 std::string Measure::getLabel() const {
-    return this->label;
+    return std::string(this->label);
 }
 
 /*
@@ -137,9 +267,25 @@ void Measure::setLabel(std::string label) {
     auto value = measure.getValue(1999); // returns 12345678.9
 */
 double Measure::getValue(unsigned int key){
-    if(this->readings.find(key) == this->readings.end())
+    const double* value = find(key);
+    if(value == nullptr)
         throw std::out_of_range("No value found for year " + std::to_string(key));
-    return this->readings.find(key)->second;
+    return *value;
+}
+
+/*
+  Find the value stored for a given year.
+
+  @param key
+    The year to find the value for
+
+  @return
+    A pointer to the value, or nullptr if there is no value for that year
+*/
+const double* Measure::find(unsigned int key) const{
+    if(key < firstYear || key - firstYear >= values.size() || !present[key - firstYear])
+        return nullptr;
+    return &values[key - firstYear];
 }
 
 /*
@@ -155,6 +301,10 @@ double Measure::getValue(unsigned int key){
   @return
     void
 
+  @throws
+    std::out_of_range if the run of years would span more than MAX_YEARS
+    years, with the message Year <year> is too far from the other years
+
   @example
     std::string codename = "Pop";
     std::string label = "Population";
@@ -163,9 +313,33 @@ double Measure::getValue(unsigned int key){
     measure.setValue(1999, 12345678.9);
 */
 void Measure::setValue(unsigned int key, double value){
-    if(this->readings.find(key) != this->readings.end())
-        this->readings.find(key)->second = value;
-    this->readings.insert(std::pair<unsigned int, double>(key,value));
+    if(values.empty()) {
+        firstYear = key;
+    }else{
+        const unsigned int lastYear = firstYear + static_cast<unsigned int>(values.size()) - 1;
+        if((key < firstYear && lastYear - key >= MAX_YEARS) ||
+           (key > lastYear && key - firstYear >= MAX_YEARS))
+            throw std::out_of_range("Year " + std::to_string(key) + " is too far from the other years");
+    }
+
+    //grow the run of years backwards or forwards to cover the new year
+    if(key < firstYear) {
+        unsigned int extra = firstYear - key;
+        values.insert(values.begin(), extra, 0);
+        present.insert(present.begin(), extra, false);
+        firstYear = key;
+    }
+    std::size_t index = key - firstYear;
+    if(index >= values.size()) {
+        values.resize(index + 1, 0);
+        present.resize(index + 1, false);
+    }
+
+    if(!present[index]) {
+        present[index] = true;
+        count++;
+    }
+    values[index] = value;
 }
 
 /*
@@ -185,7 +359,7 @@ void Measure::setValue(unsigned int key, double value){
     auto size = measure.size(); // returns 1
 */
 unsigned int Measure::size() const{
-    return readings.size();
+    return count;
 }
 
 /*
@@ -204,7 +378,11 @@ unsigned int Measure::size() const{
     auto diff = measure.getDifference(); // returns 1.0
 */
 double Measure::getDifference() const{
-    return  ( readings.rbegin()->second - readings.begin()->second);
+    if(count == 0)
+        return 0;
+
+    //the run of years always starts and ends with a year that has data
+    return  ( values.back() - values.front());
 }
 
 /*
@@ -225,7 +403,7 @@ double Measure::getDifference() const{
 double Measure::getDifferenceAsPercentage() const{
     if(getDifference() == 0)
         return 0;
-    return ((getDifference()/readings.begin()->second) * 100);
+    return ((getDifference()/values.front()) * 100);
 }
 
 /*
@@ -244,14 +422,15 @@ double Measure::getDifferenceAsPercentage() const{
 */
 double Measure::getAverage() const{
 
-    if(readings.size() == 0)
+    if(count == 0)
         return 0;
 
     double sum = 0;
-    for (auto const& reading : readings)
-        sum += reading.second;
+    for (std::size_t i = 0; i < values.size(); i++)
+        if(present[i])
+            sum += values[i];
 
-    return (sum/readings.size());
+    return (sum/count);
 }
 
 /*
@@ -293,12 +472,14 @@ double Measure::getAverage() const{
 */
 std::ostream &operator<<(std::ostream &os, const Measure &measure) {
     std::string tab = "    ";
-    os << measure.label << tab << '(' << measure.codename << ')' << std::endl;
-    for (auto const &reading : measure.readings)
-        os << tab << reading.first;
+    os << measure.label << tab << '(' << measure.getCodename() << ')' << std::endl;
+    for (std::size_t i = 0; i < measure.values.size(); i++)
+        if(measure.present[i])
+            os << tab << measure.firstYear + i;
     os << tab << "Average" << tab << "Diff." << tab <<" % Diff." << std::endl;
-    for (auto const &reading : measure.readings)
-        os << std::to_string(reading.second) << ' ';
+    for (std::size_t i = 0; i < measure.values.size(); i++)
+        if(measure.present[i])
+            os << std::to_string(measure.values[i]) << ' ';
     os << std::to_string(measure.getAverage()) << tab << std::to_string(measure.getDifference()) << tab
     << std::to_string(measure.getDifferenceAsPercentage()) << std::endl;
     return os;
@@ -325,7 +506,17 @@ bool operator==(const Measure& lhs, const Measure& rhs){
     if(lhs.label != rhs.label)
         return false;
 
-    return lhs.readings == rhs.readings;
+    if(lhs.count != rhs.count)
+        return false;
+
+    for (std::size_t i = 0; i < lhs.values.size(); i++) {
+        if(lhs.present[i]) {
+            const double* value = rhs.find(lhs.firstYear + i);
+            if(value == nullptr || *value != lhs.values[i])
+                return false;
+        }
+    }
+    return true;
 }
 
 /*
@@ -343,8 +534,34 @@ bool operator==(const Measure& lhs, const Measure& rhs){
     Measure measure2("MYCODE1");
     measure1.merge(measure2);
 */
-void Measure::merge(Measure measureNew){
-    readings.insert(measureNew.readings.begin(), measureNew.readings.end());
+void Measure::merge(const Measure& measureNew){
+    for (std::size_t i = 0; i < measureNew.values.size(); i++)
+        if(measureNew.present[i] && find(measureNew.firstYear + i) == nullptr)
+            setValue(measureNew.firstYear + i, measureNew.values[i]);
+}
+
+/*
+  Combine another Measure into this one in place. The other Measure's
+  codename, label and values replace this Measure's, and values for years
+  only this Measure has are kept. This gives the same Measure as merging this
+  one into a copy of the other, without the copy.
+
+  @param measureNew
+    The Measure whose data takes precedence
+
+  @example
+    Measure measure1("pop", "Population");
+    measure1.setValue(1999, 1);
+    Measure measure2("Pop", "Population (mid-year)");
+    measure2.setValue(2000, 2);
+    measure1.overwrite(measure2); // 1999 and 2000, labelled as measure2
+*/
+void Measure::overwrite(const Measure& measureNew){
+    codename = measureNew.codename;
+    label = measureNew.label;
+    for (std::size_t i = 0; i < measureNew.values.size(); i++)
+        if(measureNew.present[i])
+            setValue(measureNew.firstYear + i, measureNew.values[i]);
 }
 
 /*
@@ -354,10 +571,42 @@ void Measure::merge(Measure measureNew){
     std::string
 */
 std::string Measure::toJSON() const{
-    json j;
-    for (auto const& reading : readings)
-        j[std::to_string(reading.first)] = reading.second;
+    std::ostringstream os;
+    JSONWriter writer(os);
+    writeJSON(writer);
+    return os.str();
+}
 
-    return j.dump();
+/*
+  Write the readings in this Measure as a JSON object, keyed by year, or
+  null if there are no readings. This is what toJSON() returns, written
+  straight to the JSONWriter instead.
+
+  @param writer
+    The JSONWriter to write to
+
+  @example
+    Measure measure("pop", "Population");
+    measure.setValue(2010, 12345679.9);
+
+    JSONWriter writer(std::cout);
+    measure.writeJSON(writer); // {"2010":12345679.9}
+*/
+void Measure::writeJSON(JSONWriter& writer) const{
+    if(count == 0) {
+        writer.null();
+        return;
+    }
+
+    //years are written in numeric order, which is also key order for the
+    //four digit years in our data
+    writer.beginObject();
+    for (std::size_t i = 0; i < values.size(); i++) {
+        if(present[i]) {
+            writer.key(std::to_string(firstYear + i));
+            writer.value(values[i]);
+        }
+    }
+    writer.endObject();
 }
 
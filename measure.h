@@ -13,9 +13,13 @@
   functions and member variables you need to declare in this class.
  */
 
+#include <cstddef>
 #include <string>
-#include <map>
+#include <vector>
 #include <iostream>
+#include <memory_resource>
+#include "jsonwriter.h"
+#include "symbols.h"
 
 /*
   The Measure class contains a measure code, label, and a container for readings
@@ -25,20 +29,53 @@
   to overload.
 */
 class Measure {
+public:
+    //the label and readings are allocated with this (see Areas)
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
 private:
-    //code idefing the data
-    std::string codename;
+    //code idefing the data (an ID in SymbolTable::measures())
+    SymbolID codename = 0;
 
     //Readable label discriabing the data
-    std::string label;
+    std::pmr::string label;
+
+    /* The readings are stored as a dense run of years starting at firstYear,
+     * as our data is nearly always for consecutive years. Years in the run
+     * without data are marked as missing in present. */
+
+    //the year of the first slot in values
+    unsigned int firstYear = 0;
+
+    //Index = year - firstYear | Value = the data for that year
+    std::pmr::vector<double> values;
+
+    //Index = year - firstYear | Value = true if there is data for that year
+    std::pmr::vector<bool> present;
 
-    //Key = the year for the data | Value = the data
-    std::map<unsigned int, double> readings;
+    //the number of years that have data
+    unsigned int count = 0;
+
+    /*----Helper----*/
+    const double* find(unsigned int key) const;
 
 public:
+  //the most years the run may span, so that a year far from the others
+  //cannot make setValue() allocate an enormous run
+  static const unsigned int MAX_YEARS = 1 << 16;
+
   /*----Constructor----*/
   Measure() = default;
-  Measure(std::string code, const std::string &label);
+  explicit Measure(const allocator_type& alloc);
+  Measure(std::string code, const std::string &label, const allocator_type& alloc = {});
+  Measure(const Measure& other) = default;
+  Measure(Measure&& other) noexcept;
+  Measure(const Measure& other, const allocator_type& alloc);
+  Measure(Measure&& other, const allocator_type& alloc);
+
+  /*----Assignment----*/
+  Measure& operator=(const Measure& other) = default;
+  Measure& operator=(Measure&& other);
 
   /*----Setters----*/
   void setLabel(std::string label);
@@ -53,13 +90,25 @@ public:
   double getAverage() const;
 
   /*----Miscellaneous----*/
+  allocator_type get_allocator() const;
   unsigned int size() const;
-  void merge(Measure measureNew);
+  void merge(const Measure& measureNew);
+  void overwrite(const Measure& measureNew);
   std::string toJSON() const;
+  void writeJSON(JSONWriter& writer) const;
 
   /*----Overrides----*/
   friend bool operator==(const Measure& lhs, const Measure& rhs);
   friend std::ostream& operator<<(std::ostream& os, const Measure& measure);
+
+  /*----Snapshots read and write the readings directly----*/
+  friend class Snapshot;
+
+  /*----A ColumnStore builds the measures directly----*/
+  friend class ColumnStore;
+
+  /*----An Area updates its Measures in place----*/
+  friend class Area;
 };
 
 #endif // MEASURE_H_
\ No newline at end of file
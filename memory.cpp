@@ -0,0 +1,108 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the CountingResource class. See the
+  header file for additional comments.
+*/
+
+#include "memory.h"
+
+/*
+  Construct a CountingResource that passes allocations on to another resource.
+
+  @param upstream
+    The resource to allocate from, the heap by default
+
+  @example
+    CountingResource heap;
+    std::pmr::monotonic_buffer_resource arena(&heap);
+    Areas data(&arena);
+*/
+CountingResource::CountingResource(std::pmr::memory_resource* upstream)
+    : upstream(upstream) {}
+
+/*
+  Allocate from the upstream resource, counting the allocation.
+
+  @param bytes
+    The number of bytes to allocate
+
+  @param alignment
+    The alignment of the memory
+
+  @return
+    The memory
+
+  @throws
+    std::bad_alloc (or whatever the upstream resource throws) if the memory
+    cannot be allocated
+*/
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* p = upstream->allocate(bytes, alignment);
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    return p;
+}
+
+/*
+  Return memory to the upstream resource. Deallocations are not counted.
+
+  @param p
+    The memory, from do_allocate()
+
+  @param bytes
+    The number of bytes that were allocated
+
+  @param alignment
+    The alignment the memory was allocated with
+*/
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    upstream->deallocate(p, bytes, alignment);
+}
+
+/*
+  Memory from a CountingResource can only be freed by the same one.
+
+  @param other
+    Another memory resource
+
+  @return
+    true if other is this resource
+*/
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+/*
+  Get the number of allocations made so far.
+
+  @return
+    The number of allocations
+
+  @example
+    CountingResource heap;
+    Areas data(&heap);
+    ...
+    std::cout << heap.allocations() << " allocations" << std::endl;
+*/
+std::uint64_t CountingResource::allocations() const {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+/*
+  Get the total number of bytes asked for so far. Bytes that have been freed
+  since are not taken off.
+
+  @return
+    The number of bytes
+
+  @example
+    auto bytes = heap.bytes();
+*/
+std::uint64_t CountingResource::bytes() const {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
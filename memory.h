@@ -0,0 +1,54 @@
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the CountingResource class, a memory
+  resource that counts the allocations made through it.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/*
+  Areas, Area and Measure allocate through a std::pmr::memory_resource given
+  to Areas, rather than each allocating from the heap. A CountingResource
+  passes every allocation on to another resource (the heap by default) and
+  counts how many allocations were made and how many bytes were asked for.
+
+  Put under an arena (e.g. a std::pmr::monotonic_buffer_resource) it counts
+  the blocks the arena takes from the heap; used directly it counts every
+  allocation of the object graph. The counts are kept atomically, as shards
+  of a threaded import may allocate through it at the same time.
+*/
+class CountingResource : public std::pmr::memory_resource {
+private:
+    //where allocations are passed on to
+    std::pmr::memory_resource* upstream;
+
+    //the number of allocations, and the bytes asked for, so far
+    std::atomic<std::uint64_t> allocationCount{0};
+    std::atomic<std::uint64_t> allocatedBytes{0};
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    /*----Constructor----*/
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    /*----Getters----*/
+    std::uint64_t allocations() const;
+    std::uint64_t bytes() const;
+};
+
+#endif // MEMORY_H_
@@ -0,0 +1,99 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the functions that turn the text of values and years in
+  the datasets into numbers. They are built on std::from_chars, which does not
+  allocate, throw or look at the locale, and so is much faster than std::stod
+  and std::stol on the wide AuthorityByYearCSV files.
+*/
+
+#include <cctype>
+#include <charconv>
+#include <exception>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include "numbers.h"
+
+/*
+  Parse a decimal number from text. Like std::stod, leading whitespace and a
+  leading + are skipped, and parsing stops at the first character that is not
+  part of the number, e.g. "12.5kg" gives 12.5. Unlike std::stod, a decimal
+  point is always '.', whatever the locale.
+
+  @param text
+    The text to parse
+
+  @param value
+    Set to the number, if one was found
+
+  @return
+    true if the text starts with a number, false if it does not or the number
+    is too large to store in a double
+
+  @example
+    double value;
+    if(!BethYw::parseDouble("95.701706", value))
+      throw std::invalid_argument("Not a number");
+*/
+bool BethYw::parseDouble(std::string_view text, double &value) noexcept {
+    std::size_t start = 0;
+    while(start < text.size() && std::isspace(static_cast<unsigned char>(text[start])))
+        start++;
+    if(start < text.size() && text[start] == '+')
+        start++;
+
+    const char* first = text.data() + start;
+    const char* last = text.data() + text.size();
+
+#if defined(__cpp_lib_to_chars)
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr != first;
+#else
+    //older standard libraries only have from_chars for whole numbers, so the
+    //number is read with a stream in the classic locale rather than with
+    //std::strtod, which follows the C locale's decimal point
+    try {
+        std::istringstream stream(std::string(first, last));
+        stream.imbue(std::locale::classic());
+        double parsed;
+        if(!(stream >> parsed))
+            return false;
+        value = parsed;
+        return true;
+    } catch(const std::exception&) {
+        return false;
+    }
+#endif
+}
+
+/*
+  Parse a whole, non-negative number from text. The whole of the text must be
+  digits.
+
+  @param text
+    The text to parse
+
+  @param value
+    Set to the number, if one was found
+
+  @return
+    true if the text is a number that fits in an unsigned int, false otherwise
+
+  @example
+    unsigned int year;
+    if(!BethYw::parseUnsigned("2015", year))
+      throw std::invalid_argument("Not a year");
+*/
+bool BethYw::parseUnsigned(std::string_view text, unsigned int &value) noexcept {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last && first != last;
+}
@@ -0,0 +1,33 @@
+#ifndef NUMBERS_H_
+#define NUMBERS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains declarations for the functions that turn the text of
+  values and years in the datasets into numbers.
+ */
+
+#include <string_view>
+
+namespace BethYw {
+
+/*
+  Parse a decimal number (e.g. a value from a dataset) from text, without
+  throwing an exception or depending on the locale.
+*/
+bool parseDouble(std::string_view text, double &value) noexcept;
+
+/*
+  Parse a whole, non-negative number (e.g. a year) from text, without
+  throwing an exception.
+*/
+bool parseUnsigned(std::string_view text, unsigned int &value) noexcept;
+
+} // namespace BethYw
+
+#endif // NUMBERS_H_
@@ -0,0 +1,608 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the ODataScanner class. See the
+  header file for additional comments.
+*/
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "odata.h"
+#include "numbers.h"
+
+/*
+  Find the first byte from p that ends a run of plain string characters: a
+  quote, a backslash, a control character or a byte of a multi-byte UTF-8
+  sequence. Compared as signed chars, the last two are exactly the bytes less
+  than 0x20, so each block of bytes needs only three comparisons.
+
+  @param p
+    Where to start
+
+  @param end
+    The end of the buffer
+
+  @return
+    A pointer to the byte, or end if there is none
+*/
+static const char* findSpecial(const char* p, const char* end) noexcept {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i space = _mm256_set1_epi8(0x20);
+    while(end - p >= 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)),
+            _mm256_cmpgt_epi8(space, bytes));
+        const unsigned int mask = _mm256_movemask_epi8(special);
+        if(mask != 0)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+    while(end - p >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+            _mm_cmplt_epi8(bytes, space));
+        const unsigned int mask = _mm_movemask_epi8(special);
+        if(mask != 0)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while(p < end && *p != '"' && *p != '\\' && static_cast<signed char>(*p) >= 0x20)
+        p++;
+    return p;
+}
+
+/*
+  Get the length of the well formed UTF-8 sequence (RFC 3629) starting at p,
+  the same sequences nlohmann::json accepts in a string.
+
+  @param p
+    The first byte of the sequence (0x80 or above)
+
+  @param end
+    The end of the buffer
+
+  @return
+    The length of the sequence, or 0 if it is not well formed
+*/
+static std::size_t utf8Length(const char* p, const char* end) noexcept {
+    auto byte = [&](std::size_t i) {
+        return p + i < end ? static_cast<unsigned char>(p[i]) : 0;
+    };
+    auto continuation = [&](std::size_t i, unsigned char low = 0x80, unsigned char high = 0xBF) {
+        return byte(i) >= low && byte(i) <= high;
+    };
+
+    const unsigned char lead = byte(0);
+    if(lead >= 0xC2 && lead <= 0xDF)
+        return continuation(1) ? 2 : 0;
+    if(lead == 0xE0)
+        return continuation(1, 0xA0) && continuation(2) ? 3 : 0;
+    if((lead >= 0xE1 && lead <= 0xEC) || lead == 0xEE || lead == 0xEF)
+        return continuation(1) && continuation(2) ? 3 : 0;
+    if(lead == 0xED)
+        return continuation(1, 0x80, 0x9F) && continuation(2) ? 3 : 0;
+    if(lead == 0xF0)
+        return continuation(1, 0x90) && continuation(2) && continuation(3) ? 4 : 0;
+    if(lead >= 0xF1 && lead <= 0xF3)
+        return continuation(1) && continuation(2) && continuation(3) ? 4 : 0;
+    if(lead == 0xF4)
+        return continuation(1, 0x80, 0x8F) && continuation(2) && continuation(3) ? 4 : 0;
+    return 0;
+}
+
+/*
+  Construct a scanner positioned at the start of a document.
+
+  @param buffer
+    The whole JSON document, which must outlive the scanner
+
+  @param strict
+    If true, the document must be followed by nothing but whitespace (as with
+    json::parse()), otherwise anything after it is ignored (as with
+    operator>>)
+
+  @throws
+    ODataScanner::Unexpected if the document is not an object
+
+  @example
+    ODataScanner scanner(input.open(), true);
+*/
+ODataScanner::ODataScanner(std::string_view buffer, bool strict)
+    : begin(buffer.data()), pos(buffer.data()), end(buffer.data() + buffer.size()), strict(strict) {
+    //a byte order mark is skipped, as nlohmann::json does
+    if(buffer.size() >= 3 && buffer.substr(0, 3) == "\xEF\xBB\xBF")
+        pos += 3;
+
+    skipWhitespace();
+    if(pos == end || *pos != '{')
+        unexpected("a document that is not an object");
+    pos++;
+}
+
+/*
+  Throw ODataScanner::Unexpected.
+
+  @param what
+    What was found
+*/
+void ODataScanner::unexpected(const char* what) const {
+    throw Unexpected(std::string("ODataScanner cannot read ") + what);
+}
+
+/*
+  Skip over JSON whitespace.
+*/
+void ODataScanner::skipWhitespace() noexcept {
+    while(pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+        pos++;
+}
+
+/*
+  Move on to the next member of the object or array being read, or past its
+  closing bracket.
+
+  @param close
+    The closing bracket of the object or array
+
+  @return
+    true if there is another member, false if the closing bracket was read
+
+  @throws
+    ODataScanner::Unexpected if neither follows
+*/
+bool ODataScanner::nextMember(char close) {
+    skipWhitespace();
+    if(pos == end)
+        unexpected("an unfinished document");
+
+    if(*pos == close) {
+        pos++;
+        first = false;
+        return false;
+    }
+
+    if(!first) {
+        if(*pos != ',')
+            unexpected("a missing comma");
+        pos++;
+        skipWhitespace();
+    }
+    first = false;
+    return true;
+}
+
+/*
+  Read a string without escape sequences, checking it is valid UTF-8.
+
+  @return
+    A view of the characters between the quotes, in the buffer
+*/
+std::string_view ODataScanner::scanString() {
+    if(pos == end || *pos != '"')
+        unexpected("a missing string");
+
+    const char* start = ++pos;
+    while(true) {
+        pos = findSpecial(pos, end);
+        if(pos == end)
+            unexpected("an unfinished string");
+
+        const unsigned char ch = *pos;
+        if(ch == '"')
+            break;
+        if(ch == '\\')
+            unexpected("an escape sequence");
+        if(ch < 0x20)
+            unexpected("a control character in a string");
+
+        const std::size_t length = utf8Length(pos, end);
+        if(length == 0)
+            unexpected("invalid UTF-8");
+        pos += length;
+    }
+
+    return std::string_view(start, pos++ - start);
+}
+
+/*
+  Read a number, checking it has the form JSON allows.
+
+  @param isInteger
+    Set to true if the number has no fraction or exponent
+
+  @return
+    A view of the number, in the buffer
+*/
+std::string_view ODataScanner::scanNumber(bool& isInteger) {
+    auto digits = [&]() {
+        const char* start = pos;
+        while(pos < end && *pos >= '0' && *pos <= '9')
+            pos++;
+        if(pos == start)
+            unexpected("a malformed number");
+    };
+
+    const char* start = pos;
+    if(pos < end && *pos == '-')
+        pos++;
+    if(pos < end && *pos == '0')
+        pos++;
+    else
+        digits();
+
+    isInteger = true;
+    if(pos < end && *pos == '.') {
+        pos++;
+        digits();
+        isInteger = false;
+    }
+    if(pos < end && (*pos == 'e' || *pos == 'E')) {
+        pos++;
+        if(pos < end && (*pos == '+' || *pos == '-'))
+            pos++;
+        digits();
+        isInteger = false;
+    }
+
+    return std::string_view(start, pos - start);
+}
+
+/*
+  Skip over true, false or null.
+
+  @param literal
+    The literal expected
+*/
+void ODataScanner::skipLiteral(std::string_view literal) {
+    if(std::string_view(pos, end - pos).substr(0, literal.size()) != literal)
+        unexpected("an unknown literal");
+    pos += literal.size();
+}
+
+/*
+  Move on to the next record of a "value" array. Any other member of the
+  document, and the rest of the current record if it was not read to the
+  end, is skipped.
+
+  @return
+    true if there is another record, which is ready for nextKey(), or false
+    at the end of the document
+
+  @throws
+    ODataScanner::Unexpected if the document cannot be read by the scanner
+
+  @example
+    while(scanner.nextRecord()) {
+      std::string_view key;
+      while(scanner.nextKey(key))
+        scanner.skipValue();
+    }
+*/
+bool ODataScanner::nextRecord() {
+    while(true) {
+        switch(state) {
+        case State::Done:
+            return false;
+
+        case State::Record: {
+            //the rest of an unfinished record is skipped
+            std::string_view key;
+            if(pendingValue)
+                skipValue();
+            while(nextKey(key))
+                skipValue();
+            break;
+        }
+
+        case State::Values:
+            if(!nextMember(']')) {
+                //a range must end at one of the records of its array
+                if(stop != nullptr)
+                    unexpected("a range that does not end at a record");
+                state = State::Document;
+                break;
+            }
+            if(stop != nullptr && pos >= stop) {
+                if(pos != stop)
+                    unexpected("a range that does not end at a record");
+                state = State::Done;
+                return false;
+            }
+            if(pos == end || *pos != '{')
+                unexpected("a record that is not an object");
+            pos++;
+            state = State::Record;
+            first = true;
+            return true;
+
+        case State::Document: {
+            if(!nextMember('}')) {
+                skipWhitespace();
+                if(strict && pos != end)
+                    unexpected("something after the document");
+                state = State::Done;
+                return false;
+            }
+
+            std::string_view key = scanString();
+            skipWhitespace();
+            if(pos == end || *pos != ':')
+                unexpected("a missing colon");
+            pos++;
+            skipWhitespace();
+
+            if(key == "value" && pos < end && *pos == '[') {
+                pos++;
+                state = State::Values;
+                first = true;
+            }else{
+                skipValue();
+            }
+            break;
+        }
+        }
+    }
+}
+
+/*
+  Move on to the next key of the current record.
+
+  @param key
+    Set to the key, a view of the buffer
+
+  @return
+    true if there is another key, whose value must then be read with
+    readValue() or skipped with skipValue(), or false at the end of the record
+
+  @throws
+    ODataScanner::Unexpected if the record cannot be read by the scanner
+*/
+bool ODataScanner::nextKey(std::string_view& key) {
+    if(state != State::Record)
+        return false;
+
+    if(!nextMember('}')) {
+        state = State::Values;
+        return false;
+    }
+
+    key = scanString();
+    skipWhitespace();
+    if(pos == end || *pos != ':')
+        unexpected("a missing colon");
+    pos++;
+    skipWhitespace();
+    pendingValue = true;
+    return true;
+}
+
+/*
+  Read the value of the current key, as nlohmann::json would: a string, a
+  boolean, null, or a number that is an integer if it has no fraction or
+  exponent and fits in 64 bits, and a double otherwise.
+
+  @param value
+    Set to the value. A string is copied into the string value already has,
+    if it has one, so reading the same field of every record rarely
+    allocates.
+
+  @throws
+    ODataScanner::Unexpected if the value cannot be read by the scanner
+
+  @example
+    nlohmann::json value;
+    if(key == "Data")
+      scanner.readValue(value);
+*/
+void ODataScanner::readValue(nlohmann::json& value) {
+    if(pos == end)
+        unexpected("an unfinished document");
+    pendingValue = false;
+
+    switch(*pos) {
+    case '"': {
+        std::string_view text = scanString();
+        if(value.is_string())
+            value.get_ref<std::string&>().assign(text.data(), text.size());
+        else
+            value = std::string(text);
+        return;
+    }
+    case 't':
+        skipLiteral("true");
+        value = true;
+        return;
+    case 'f':
+        skipLiteral("false");
+        value = false;
+        return;
+    case 'n':
+        skipLiteral("null");
+        value = nullptr;
+        return;
+    case '{':
+    case '[':
+        unexpected("a nested object or array");
+    default:
+        break;
+    }
+
+    bool isInteger = false;
+    std::string_view text = scanNumber(isInteger);
+    const char* last = text.data() + text.size();
+    if(isInteger && text[0] == '-') {
+        nlohmann::json::number_integer_t number = 0;
+        auto result = std::from_chars(text.data(), last, number);
+        if(result.ec == std::errc() && result.ptr == last) {
+            value = number;
+            return;
+        }
+    }else if(isInteger) {
+        nlohmann::json::number_unsigned_t number = 0;
+        auto result = std::from_chars(text.data(), last, number);
+        if(result.ec == std::errc() && result.ptr == last) {
+            value = number;
+            return;
+        }
+    }
+
+    //like nlohmann::json, integers too large for 64 bits are read as doubles
+    double number = 0;
+    if(!BethYw::parseDouble(text, number))
+        unexpected("a number out of range");
+    value = number;
+}
+
+/*
+  Skip over the value of the current key (or of a member of the document),
+  without copying or converting it.
+
+  @throws
+    ODataScanner::Unexpected if the value cannot be read by the scanner
+
+  @example
+    if(key != "Data")
+      scanner.skipValue();
+*/
+void ODataScanner::skipValue() {
+    if(pos == end)
+        unexpected("an unfinished document");
+    pendingValue = false;
+
+    bool isInteger = false;
+    switch(*pos) {
+    case '"':
+        scanString();
+        return;
+    case 't':
+        skipLiteral("true");
+        return;
+    case 'f':
+        skipLiteral("false");
+        return;
+    case 'n':
+        skipLiteral("null");
+        return;
+    case '{':
+    case '[':
+        unexpected("a nested object or array");
+    default:
+        scanNumber(isInteger);
+        return;
+    }
+}
+
+/*
+  Find where to split the records of the first "value" array of a document,
+  so that it can be read in about the given number of parts of similar size.
+  Each split is the opening brace of a record that follows "}," (with any
+  whitespace), found by searching forward from an even division of the
+  buffer.
+
+  The search does not track strings, so a split might be inside a string
+  that happens to contain "},{". A scanner given such a range does not stop
+  exactly at its end, and throws Unexpected (see setRange()).
+
+  @param buffer
+    The whole JSON document
+
+  @param parts
+    The number of parts wanted
+
+  @return
+    The offsets of the splits, in increasing order (at most parts - 1 of
+    them, and none if the document has no records)
+
+  @throws
+    ODataScanner::Unexpected if the start of the document cannot be read
+
+  @example
+    auto splits = ODataScanner::splitRecords(buffer, 4);
+*/
+std::vector<std::size_t> ODataScanner::splitRecords(std::string_view buffer, std::size_t parts) {
+    std::vector<std::size_t> splits;
+
+    //the first record is found by scanning up to it
+    ODataScanner scanner(buffer, false);
+    if(parts < 2 || !scanner.nextRecord())
+        return splits;
+    const std::size_t first = scanner.pos - scanner.begin;
+
+    auto isSpace = [](char ch) {
+        return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+    };
+
+    std::size_t from = first;
+    for(std::size_t part = 1; part < parts; part++) {
+        std::size_t at = std::max(from, first + (buffer.size() - first) * part / parts);
+        while(true) {
+            at = buffer.find('}', at);
+            if(at == std::string_view::npos)
+                return splits;
+
+            std::size_t next = at + 1;
+            while(next < buffer.size() && isSpace(buffer[next]))
+                next++;
+            if(next < buffer.size() && buffer[next] == ',') {
+                next++;
+                while(next < buffer.size() && isSpace(buffer[next]))
+                    next++;
+                if(next < buffer.size() && buffer[next] == '{') {
+                    splits.push_back(next);
+                    from = next + 1;
+                    break;
+                }
+            }
+            at++;
+        }
+    }
+    return splits;
+}
+
+/*
+  Only read the records of the "value" array from one split to another (see
+  splitRecords()). A scanner for a range after the first starts at the
+  record at from, and one for the last range carries on to the end of the
+  document.
+
+  @param from
+    The offset of the first record, from splitRecords(), or 0 to start at
+    the beginning of the document
+
+  @param to
+    The offset of the record after the range, from splitRecords(), or
+    std::string_view::npos to read to the end of the document
+
+  @example
+    ODataScanner scanner(buffer, true);
+    scanner.setRange(splits[0], splits[1]);
+*/
+void ODataScanner::setRange(std::size_t from, std::size_t to) {
+    if(from != 0) {
+        pos = begin + from;
+        state = State::Values;
+        first = true;
+    }
+    stop = to == std::string_view::npos ? nullptr : begin + to;
+}
@@ -0,0 +1,108 @@
+#ifndef ODATA_H_
+#define ODATA_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the ODataScanner class, a scanner
+  specialised for the layout of the OData JSON files from StatsWales.
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lib_json.hpp"
+
+/*
+  An ODataScanner reads the records of the "value" array of a StatsWales
+  OData JSON file straight from a block of memory, i.e. a document like
+
+    { "odata.metadata": "...", "value": [ { "Data": 95.7, ... }, ... ] }
+
+  The caller asks for each record with nextRecord(), then for each key of the
+  record with nextKey(), and either reads the key's value (readValue()) or
+  skips over it (skipValue()). A skipped value is checked but never copied or
+  converted, so a record costs little more than finding its quotes, and the
+  fields a SourceColumnMapping does not use cost almost nothing.
+
+  Strings are searched for their closing quote 32 (AVX2) or 16 (SSE2) bytes at
+  a time where the compiler targets those instruction sets, a byte at a time
+  otherwise.
+
+  A large file can be read by several scanners at once: splitRecords() finds
+  record boundaries in the "value" array, and each scanner is given the
+  records between two of them with setRange(). A scanner whose range does
+  not end exactly at a record boundary throws Unexpected.
+
+  The scanner only handles the JSON that StatsWales writes. Anything else
+  (escape sequences in strings, records that are not objects, objects or
+  arrays nested anywhere else, or a document that is not valid JSON) throws
+  ODataScanner::Unexpected, so the
+  caller can parse the file with a general JSON parser instead. Values are
+  read as nlohmann::json would read them, so either way gives the same data.
+*/
+class ODataScanner {
+public:
+    /*
+      Thrown when the document is not in the form the scanner handles.
+    */
+    class Unexpected : public std::runtime_error {
+    public:
+        explicit Unexpected(const std::string& what) : std::runtime_error(what) {}
+    };
+
+private:
+    //where the scanner has got to in the document
+    enum class State { Document, Values, Record, Done };
+
+    const char* begin;
+    const char* pos;
+    const char* end;
+
+    //where the range of records being read stops, or nullptr to read to the
+    //end of the document
+    const char* stop = nullptr;
+
+    //true if nothing but whitespace may follow the document
+    bool strict;
+
+    State state = State::Document;
+
+    //true until the first member of the current object/array has been read
+    bool first = true;
+
+    //true from nextKey() until the key's value has been read or skipped
+    bool pendingValue = false;
+
+    /*----Helpers----*/
+    [[noreturn]] void unexpected(const char* what) const;
+    void skipWhitespace() noexcept;
+    bool nextMember(char close);
+    std::string_view scanString();
+    std::string_view scanNumber(bool& isInteger);
+    void skipLiteral(std::string_view literal);
+    void skipContainer();
+
+public:
+    /*----Constructor----*/
+    ODataScanner(std::string_view buffer, bool strict);
+
+    /*----Scanning----*/
+    bool nextRecord();
+    bool nextKey(std::string_view& key);
+    void readValue(nlohmann::json& value);
+    void skipValue();
+
+    /*----Ranges----*/
+    static std::vector<std::size_t> splitRecords(std::string_view buffer, std::size_t parts);
+    void setRange(std::size_t from, std::size_t to);
+};
+
+#endif // ODATA_H_
@@ -0,0 +1,198 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the Profile class. See the header
+  file for additional comments.
+*/
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "profile.h"
+#include "jsonwriter.h"
+
+/*
+  Construct an empty Profile. The total time in the report is measured from
+  when the Profile is constructed.
+
+  @example
+    Profile profile;
+*/
+Profile::Profile() : created(Clock::now()) {}
+
+/*
+  Start timing a phase of the run. Call endPhase() when it has finished.
+
+  @param name
+    The name of the phase, as it should appear in the report
+
+  @example
+    profile.beginPhase("output");
+    std::cout << data;
+    profile.endPhase();
+*/
+void Profile::beginPhase(const std::string& name) {
+    phase = name;
+    phaseStart = Clock::now();
+    phaseAllocations = resource != nullptr ? resource->allocations() : 0;
+}
+
+/*
+  Finish timing the phase started by beginPhase(), recording its wall time,
+  the peak memory use so far and the allocations made during it.
+*/
+void Profile::endPhase() {
+    std::uint64_t allocations = resource != nullptr ? resource->allocations() - phaseAllocations : 0;
+    phases.push_back({phase, secondsSince(phaseStart), peakRSS(), allocations});
+}
+
+/*
+  Record what happened when a dataset was imported. Datasets appear in the
+  report in the order they are added.
+
+  @param dataset
+    The times and counts for the dataset
+*/
+void Profile::addDataset(const Dataset& dataset) {
+    datasets.push_back(dataset);
+}
+
+/*
+  Report the allocations made through a memory resource, e.g. the one the
+  Areas being imported into allocates from. Call this before the first phase
+  begins.
+
+  @param resource
+    The resource to report on, which must outlive the Profile
+
+  @example
+    CountingResource heap;
+    Areas data(&heap);
+    profile.countAllocations(&heap);
+*/
+void Profile::countAllocations(const CountingResource* resource) {
+    this->resource = resource;
+}
+
+/*
+  Write the report as a single line of JSON, e.g.
+    {"totalSeconds":0.25,"peakRSSBytes":...,"phases":[...],"datasets":[...]}
+
+  @param os
+    The stream to write the report to (normally std::cerr)
+
+  @example
+    profile.write(std::cerr);
+*/
+void Profile::write(std::ostream& os) const {
+    JSONWriter writer(os);
+
+    writer.beginObject();
+    writer.key("totalSeconds");
+    writer.value(secondsSince(created));
+    writer.key("peakRSSBytes");
+    writer.value(peakRSS());
+    if(resource != nullptr) {
+        writer.key("allocations");
+        writer.value(resource->allocations());
+        writer.key("allocatedBytes");
+        writer.value(resource->bytes());
+    }
+
+    writer.key("phases");
+    writer.beginArray();
+    for(auto const& phase : phases) {
+        writer.beginObject();
+        writer.key("name");
+        writer.value(phase.name);
+        writer.key("seconds");
+        writer.value(phase.seconds);
+        writer.key("peakRSSBytes");
+        writer.value(phase.peakRSS);
+        if(resource != nullptr) {
+            writer.key("allocations");
+            writer.value(phase.allocations);
+        }
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.key("datasets");
+    writer.beginArray();
+    for(auto const& dataset : datasets) {
+        writer.beginObject();
+        writer.key("code");
+        writer.value(dataset.code);
+        writer.key("file");
+        writer.value(dataset.file);
+        writer.key("bytes");
+        writer.value(dataset.bytes);
+        writer.key("openSeconds");
+        writer.value(dataset.openSeconds);
+        writer.key("parseSeconds");
+        writer.value(dataset.parseSeconds);
+        writer.key("mergeSeconds");
+        writer.value(dataset.mergeSeconds);
+        writer.key("rows");
+        writer.value(dataset.stats.rows);
+        writer.key("areasAccepted");
+        writer.value(dataset.stats.areasAccepted);
+        writer.key("measuresAccepted");
+        writer.value(dataset.stats.measuresAccepted);
+        writer.key("readingsAccepted");
+        writer.value(dataset.stats.readingsAccepted);
+        writer.key("peakRSSBytes");
+        writer.value(dataset.peakRSS);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.endObject();
+    os << std::endl;
+}
+
+/*
+  Find the wall time since a point in time.
+
+  @param start
+    The point in time to measure from
+
+  @return
+    The number of seconds since start
+
+  @example
+    auto start = Profile::Clock::now();
+    ...
+    double seconds = Profile::secondsSince(start);
+*/
+double Profile::secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+  Find the peak resident set size (physical memory use) of this process so
+  far. This is not available on Windows, where it is always 0.
+
+  @return
+    The peak resident set size in bytes
+*/
+std::uint64_t Profile::peakRSS() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    //macOS reports bytes, everywhere else reports kilobytes
+    return usage.ru_maxrss;
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
@@ -0,0 +1,105 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the Profile class, which records where
+  the time goes during a run of Beth Yw? when the --profile argument is given.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "areas.h"
+#include "memory.h"
+
+/*
+  A Profile records the wall time and peak memory use of each phase of a run
+  (e.g. importing areas.csv, importing the datasets, writing the output), and
+  for each dataset the bytes read, the time spent opening, parsing and merging
+  it, and the rows read and accepted by the filters. If given a
+  CountingResource, the number of allocations made through it is reported
+  too, in total and for each phase. The report is written as a single JSON
+  object.
+
+  Phases are timed one after another and are not nested.
+*/
+class Profile {
+public:
+    /*
+      What was recorded for importing a single dataset.
+    */
+    struct Dataset {
+        //the dataset's code and file
+        std::string code;
+        std::string file;
+
+        //size of the file
+        std::uint64_t bytes = 0;
+
+        //wall time spent opening, parsing and merging the file
+        double openSeconds = 0;
+        double parseSeconds = 0;
+        double mergeSeconds = 0;
+
+        //rows read and accepted by the filters
+        ImportStats stats;
+
+        //peak resident set size of the process after the dataset was parsed
+        std::uint64_t peakRSS = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /*
+      What was recorded for a single phase.
+    */
+    struct Phase {
+        std::string name;
+        double seconds;
+        std::uint64_t peakRSS;
+        std::uint64_t allocations;
+    };
+
+    //when the Profile was created
+    Clock::time_point created;
+
+    //the phase currently being timed and when it started
+    std::string phase;
+    Clock::time_point phaseStart;
+    std::uint64_t phaseAllocations = 0;
+
+    //the resource whose allocations are reported, if any
+    const CountingResource* resource = nullptr;
+
+    std::vector<Phase> phases;
+    std::vector<Dataset> datasets;
+
+public:
+  /*----Constructor----*/
+  Profile();
+
+  /*----Recording----*/
+  void beginPhase(const std::string& name);
+  void endPhase();
+  void addDataset(const Dataset& dataset);
+  void countAllocations(const CountingResource* resource);
+
+  /*----Output----*/
+  void write(std::ostream& os) const;
+
+  /*----Helpers----*/
+  static double secondsSince(Clock::time_point start);
+  static std::uint64_t peakRSS();
+};
+
+#endif // PROFILE_H_
@@ -0,0 +1,379 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the Snapshot class. See the header
+  file for additional comments.
+*/
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "snapshot.h"
+#include "input.h"
+
+namespace {
+
+const std::string_view MAGIC = "BYWSNAP";
+const std::uint32_t VERSION = 2;
+
+/*
+  Appends numbers and strings to a buffer in the snapshot layout.
+*/
+class SnapshotWriter {
+public:
+    std::string out;
+
+    void u32(std::uint32_t value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void u64(std::uint64_t value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void f64(double value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void string(std::string_view value) {
+        u32(value.size());
+        out.append(value.data(), value.size());
+    }
+};
+
+/*
+  Reads numbers and strings back out of a snapshot, throwing a
+  std::runtime_error if the snapshot ends early.
+*/
+class SnapshotReader {
+private:
+    std::string_view in;
+    std::size_t pos = 0;
+
+    const char* take(std::size_t size) {
+        if(size > in.size() - pos)
+            throw std::runtime_error("Snapshot: Unexpected end of file");
+        const char* bytes = in.data() + pos;
+        pos += size;
+        return bytes;
+    }
+
+public:
+    SnapshotReader(std::string_view in) : in(in) {}
+
+    std::uint32_t u32() {
+        std::uint32_t value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::uint64_t u64() {
+        std::uint64_t value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    double f64() {
+        double value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string_view bytes(std::size_t size) {
+        return std::string_view(take(size), size);
+    }
+
+    std::string_view string() {
+        return bytes(u32());
+    }
+
+    bool atEnd() const {
+        return pos == in.size();
+    }
+};
+
+} // namespace
+
+/*
+  Construct a Snapshot for a file. The file is not opened until load() or
+  save() is called, and does not need to exist yet.
+
+  The size and modification time of each source file are taken now, before
+  anything is imported from them, so that save() can tell if one changed
+  while it was being imported.
+
+  @param path
+    The path of the snapshot file
+
+  @param sources
+    The paths of the files the data is imported from, in the order they are
+    imported (see BethYw::snapshotSources())
+
+  @example
+    Snapshot snapshot("bethyw.snapshot", BethYw::snapshotSources(dir, datasets));
+*/
+Snapshot::Snapshot(const std::string& path, const std::vector<std::string>& sources) : path(path) {
+    for(auto const& source : sources)
+        this->sources.push_back(stat(source));
+}
+
+/*
+  Get the size and modification time of a file, without opening it.
+
+  @param path
+    The path of the file
+
+  @return
+    The file's Source, whose exists member is false if it could not be found
+*/
+Snapshot::Source Snapshot::stat(const std::string& path) {
+    Source source{path, false, 0, 0};
+    std::error_code error;
+    if(!std::filesystem::is_regular_file(path, error))
+        return source;
+
+    source.size = std::filesystem::file_size(path, error);
+    auto modified = std::filesystem::last_write_time(path, error);
+    source.exists = !error;
+    source.modified = modified.time_since_epoch().count();
+    return source;
+}
+
+/*
+  Load the snapshot into an Areas instance, if the snapshot exists, was
+  saved with the same key and the same source files, and none of the source
+  files have changed since. The snapshot file is memory mapped while it is
+  read.
+
+  A source file whose size and modification time match the snapshot is not
+  read at all. One with the same size but a different modification time is
+  hashed, and only counts as changed if its contents did.
+
+  A missing, out of date or damaged snapshot is not an error: the function
+  returns false and leaves areas unchanged, and the data should be imported
+  from the source files instead.
+
+  @param areas
+    The Areas instance to load into, whose contents are replaced
+
+  @param key
+    The key for the current run, as given by BethYw::snapshotKey()
+
+  @return
+    true if the snapshot was loaded, false otherwise
+
+  @example
+    Snapshot snapshot("bethyw.snapshot");
+    Areas areas;
+    if(!snapshot.load(areas, key)) {
+      ...
+    }
+*/
+bool Snapshot::load(Areas& areas, const std::string& key) const {
+    std::error_code error;
+    if(!std::filesystem::is_regular_file(path, error))
+        return false;
+
+    try {
+        MappedInputFile file(path);
+        SnapshotReader in(file.open());
+
+        if(in.bytes(MAGIC.size()) != MAGIC || in.u32() != VERSION || in.string() != key)
+            return false;
+
+        if(in.u32() != sources.size())
+            return false;
+        for(auto const& source : sources) {
+            if(in.string() != source.path)
+                return false;
+            std::uint64_t size = in.u64();
+            std::int64_t modified = static_cast<std::int64_t>(in.u64());
+            std::uint64_t hash = in.u64();
+            if(!source.exists || size != source.size)
+                return false;
+            if(modified != source.modified && hashFile(source.path) != hash)
+                return false;
+        }
+
+        Areas loaded(areas.getResource());
+        for(std::uint32_t a = in.u32(); a > 0; a--) {
+            Area newArea(std::string(in.string()), loaded.areas.get_allocator());
+            SymbolID code = newArea.getLocalAuthorityID();
+            Area& area = loaded.areas.emplace(code, std::move(newArea)).first->second;
+            for(std::uint32_t n = in.u32(); n > 0; n--) {
+                SymbolID lang = SymbolTable::languages().intern(in.string());
+                area.names.emplace(lang, std::string(in.string()));
+            }
+
+            for(std::uint32_t m = in.u32(); m > 0; m--) {
+                SymbolID measureKey = SymbolTable::measures().intern(in.string());
+                std::string codename(in.string());
+                std::string label(in.string());
+                Measure& measure = area.measures.emplace(measureKey, Measure(codename, label, area.measures.get_allocator())).first->second;
+
+                for(std::uint32_t r = in.u32(); r > 0; r--) {
+                    std::uint32_t year = in.u32();
+                    measure.setValue(year, in.f64());
+                }
+            }
+        }
+
+        if(!in.atEnd())
+            return false;
+
+        areas.areas = std::move(loaded.areas);
+        areas.columns.clear();
+        areas.rowsApplied = 0;
+        areas.areasApplied = 0;
+        areas.columnsChanged = false;
+        return true;
+    }catch(const std::exception&) {
+        return false;
+    }
+}
+
+/*
+  Save an Areas instance to the snapshot file, replacing any snapshot already
+  there. The snapshot is written to a temporary file first and then renamed,
+  so an interrupted save never leaves a partial snapshot behind.
+
+  @param areas
+    The Areas instance to save
+
+  @param key
+    The key for the current run, as given by BethYw::snapshotKey()
+
+  @throws
+    std::runtime_error if the snapshot could not be written, or a source file
+    is missing or changed after the Snapshot was constructed (in which case
+    the data may not match it)
+
+  @example
+    Snapshot snapshot("bethyw.snapshot");
+    snapshot.save(areas, key);
+*/
+void Snapshot::save(const Areas& areas, const std::string& key) const {
+    areas.materialise();
+
+    SnapshotWriter out;
+    out.out.append(MAGIC.data(), MAGIC.size());
+    out.u32(VERSION);
+    out.string(key);
+
+    out.u32(sources.size());
+    for(auto const& source : sources) {
+        const Source now = stat(source.path);
+        if(!now.exists || now.size != source.size || now.modified != source.modified)
+            throw std::runtime_error("Snapshot::save: Source file changed while it was imported: " + source.path);
+
+        out.string(source.path);
+        out.u64(source.size);
+        out.u64(static_cast<std::uint64_t>(source.modified));
+        out.u64(hashFile(source.path));
+    }
+
+    out.u32(areas.areas.size());
+    for(auto const& area : areas.areas) {
+        out.string(area.second.getLocalAuthorityCode());
+        out.u32(area.second.names.size());
+        for(auto const& name : area.second.names) {
+            out.string(SymbolTable::languages().name(name.first));
+            out.string(name.second);
+        }
+
+        out.u32(area.second.measures.size());
+        for(auto const& entry : area.second.measures) {
+            const Measure& measure = entry.second;
+            out.string(SymbolTable::measures().name(entry.first));
+            out.string(measure.getCodename());
+            out.string(measure.label);
+
+            out.u32(measure.count);
+            for(std::size_t i = 0; i < measure.values.size(); i++) {
+                if(measure.present[i]) {
+                    out.u32(measure.firstYear + i);
+                    out.f64(measure.values[i]);
+                }
+            }
+        }
+    }
+
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(out.out.data(), out.out.size());
+        if(!file)
+            throw std::runtime_error("Snapshot::save: Failed to write file " + temp);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if(error)
+        throw std::runtime_error("Snapshot::save: Failed to write file " + path);
+}
+
+/*
+  Hash a block of bytes. This is used to notice when the contents of a source
+  file change, not for security. The bytes are taken a 64-bit word at a time,
+  each mixed in with a multiply, so the hash runs at close to memory speed
+  rather than a byte per step.
+
+  @param bytes
+    The bytes to hash
+
+  @return
+    The hash of the bytes
+
+  @example
+    auto hash = Snapshot::hash("give me 100%");
+*/
+std::uint64_t Snapshot::hash(std::string_view bytes) {
+    const std::uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+    //mix a word into the hash, so that every bit of it affects every bit
+    //of the result
+    auto mix = [&](std::uint64_t hash, std::uint64_t word) {
+        hash = (hash ^ word) * MULTIPLIER;
+        return hash ^ (hash >> 29);
+    };
+
+    std::uint64_t hash = 0xcbf29ce484222325ULL ^ bytes.size();
+    std::size_t i = 0;
+    for(; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = mix(hash, word);
+    }
+
+    //the last few bytes, padded with zeros (the length is already mixed in)
+    if(i < bytes.size()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+        hash = mix(hash, word);
+    }
+
+    return mix(hash, 0);
+}
+
+/*
+  Hash the contents of a file (see hash()). The file is memory mapped.
+
+  @param path
+    The path of the file
+
+  @return
+    The hash of the file's contents
+
+  @throws
+    std::runtime_error if the file could not be opened
+*/
+std::uint64_t Snapshot::hashFile(const std::string& path) {
+    MappedInputFile file(path);
+    return hash(file.open());
+}
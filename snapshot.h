@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the Snapshot class, which saves a fully
+  populated Areas object to a binary file and loads it back again, so that
+  unchanged datasets do not have to be parsed on every run.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "areas.h"
+
+/*
+  A Snapshot is a binary file holding the contents of an Areas object, along
+  with a key describing what it was imported from (see BethYw::snapshotKey())
+  and the size, modification time and content hash of each source file. A
+  snapshot is only loaded if its key matches the key for the current run and
+  none of its source files have changed, so it is ignored as soon as a source
+  file or a filter changes.
+
+  Checking the source files only costs a stat() of each while their sizes
+  and modification times match the snapshot. A file is only hashed again if
+  its size is the same but its modification time is not (e.g. it was copied
+  or touched), and it is only hashed when a snapshot is saved, after it has
+  been imported and while it is still in the page cache.
+
+  The file is laid out as:
+    magic ("BYWSNAP"), version, key, each source file, then each Area
+  where each source file is its path, size, modification time and hash, each
+  Area is its code, names and Measures, and each Measure is its codename,
+  label and (year, value) readings. Numbers are written in the native byte
+  order of the machine, so snapshots should not be shared between machines.
+*/
+class Snapshot {
+private:
+    /*
+      A source file, as it was when the Snapshot was constructed.
+    */
+    struct Source {
+        std::string path;
+        bool exists;
+        std::uint64_t size;
+        std::int64_t modified;
+    };
+
+    //path of the snapshot file
+    const std::string path;
+
+    //the source files, in the order they are imported
+    std::vector<Source> sources;
+
+    /*----Helper----*/
+    static Source stat(const std::string& path);
+    static std::uint64_t hashFile(const std::string& path);
+
+public:
+  /*----Constructor----*/
+  Snapshot(const std::string& path, const std::vector<std::string>& sources = {});
+
+  /*----Loading and saving----*/
+  bool load(Areas& areas, const std::string& key) const;
+  void save(const Areas& areas, const std::string& key) const noexcept(false);
+
+  /*----Helper----*/
+  static std::uint64_t hash(std::string_view bytes);
+};
+
+#endif // SNAPSHOT_H_
@@ -0,0 +1,243 @@
+#ifndef SYMBOLMAP_H_
+#define SYMBOLMAP_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the SymbolMap class template, an open addressing hash
+  map keyed by SymbolIDs, which Areas stores its Area objects in.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "symbols.h"
+
+/*
+  A SymbolMap maps SymbolIDs to values, with (a subset of) the interface of
+  std::unordered_map, so it can be used as the AreasContainer.
+
+  The entries are kept in a deque, in the order they were added, so
+  references to them stay valid as more are added (as they do in
+  std::unordered_map). Lookups go through a separate table of slots, each
+  holding a key and the index of its entry, using open addressing with linear
+  probing: finding a key reads a few adjacent slots of one array, rather than
+  following a bucket's linked list. SymbolIDs are small consecutive integers,
+  so a multiplicative hash spreads them evenly over the table.
+
+  Entries cannot be removed one at a time, only all at once with clear().
+  Iteration is in the order entries were added; output that needs to be in
+  key order uses SymbolTable::sorted().
+
+  Everything is allocated from the memory resource the SymbolMap is
+  constructed with, and values that take an allocator (e.g. Area) are given
+  it too.
+*/
+template<class T>
+class SymbolMap {
+public:
+    using key_type = SymbolID;
+    using mapped_type = T;
+    using value_type = std::pair<const SymbolID, T>;
+    using size_type = std::size_t;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using iterator = typename std::pmr::deque<value_type>::iterator;
+    using const_iterator = typename std::pmr::deque<value_type>::const_iterator;
+
+private:
+    /*
+      A slot in the lookup table, either empty or holding a key and the index
+      of its entry.
+    */
+    struct Slot {
+        SymbolID key;
+        std::uint32_t entry;
+    };
+
+    //the entry index of an empty slot
+    static constexpr std::uint32_t EMPTY = UINT32_MAX;
+
+    //Index = the order entries were added | Value = the entry
+    std::pmr::deque<value_type> entries;
+
+    //the lookup table, whose size is 0 or a power of two at least twice the
+    //number of entries
+    std::pmr::vector<Slot> slots;
+
+    //the table has 2^bits slots
+    unsigned int bits = 0;
+
+    /*
+      The slot a key's search starts from (Fibonacci hashing).
+    */
+    std::size_t home(SymbolID key) const {
+        return static_cast<std::uint32_t>(key * 2654435769u) >> (32 - bits);
+    }
+
+    /*
+      Find the slot holding a key, or the empty slot where it would go.
+    */
+    std::size_t probe(SymbolID key) const {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t slot = home(key);
+        while(slots[slot].entry != EMPTY && slots[slot].key != key)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    /*
+      Rebuild the lookup table with 2^bits slots.
+    */
+    void rehash(unsigned int newBits) {
+        bits = newBits;
+        slots.assign(std::size_t(1) << bits, Slot{0, EMPTY});
+        for(std::uint32_t entry = 0; entry < entries.size(); entry++) {
+            std::size_t slot = probe(entries[entry].first);
+            slots[slot] = Slot{entries[entry].first, entry};
+        }
+    }
+
+public:
+    /*----Constructors----*/
+    SymbolMap() : SymbolMap(std::pmr::get_default_resource()) {}
+    explicit SymbolMap(std::pmr::memory_resource* resource) : entries(resource), slots(resource) {}
+    explicit SymbolMap(const allocator_type& alloc) : SymbolMap(alloc.resource()) {}
+    SymbolMap(const SymbolMap& other) = default;
+
+    SymbolMap(SymbolMap&& other)
+        : entries(std::move(other.entries)), slots(std::move(other.slots)), bits(other.bits) {
+        other.clear();
+    }
+
+    /*
+      Move the entries of another SymbolMap into this one. They are only
+      copied if the two use different memory resources.
+    */
+    SymbolMap& operator=(SymbolMap&& other) {
+        if(this == &other)
+            return *this;
+        if(get_allocator() == other.get_allocator()) {
+            entries.swap(other.entries);
+            slots.swap(other.slots);
+            std::swap(bits, other.bits);
+        }else{
+            clear();
+            for(auto& entry : other.entries)
+                try_emplace(entry.first, std::move(entry.second));
+        }
+        other.clear();
+        return *this;
+    }
+
+    /*----Lookup----*/
+    iterator find(SymbolID key) {
+        if(slots.empty())
+            return entries.end();
+        const Slot& slot = slots[probe(key)];
+        return slot.entry == EMPTY ? entries.end() : entries.begin() + slot.entry;
+    }
+
+    const_iterator find(SymbolID key) const {
+        if(slots.empty())
+            return entries.end();
+        const Slot& slot = slots[probe(key)];
+        return slot.entry == EMPTY ? entries.end() : entries.begin() + slot.entry;
+    }
+
+    size_type count(SymbolID key) const {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    T& at(SymbolID key) {
+        auto found = find(key);
+        if(found == end())
+            throw std::out_of_range("SymbolMap::at: no entry with ID " + std::to_string(key));
+        return found->second;
+    }
+
+    const T& at(SymbolID key) const {
+        auto found = find(key);
+        if(found == end())
+            throw std::out_of_range("SymbolMap::at: no entry with ID " + std::to_string(key));
+        return found->second;
+    }
+
+    T& operator[](SymbolID key) {
+        return try_emplace(key).first->second;
+    }
+
+    /*----Insertion----*/
+
+    /*
+      Add an entry for a key, constructing its value from args, unless there
+      is already one.
+
+      @return
+        The entry for the key, and true if it was added
+    */
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(SymbolID key, Args&&... args) {
+        std::size_t slot = slots.empty() ? 0 : probe(key);
+        if(!slots.empty() && slots[slot].entry != EMPTY)
+            return {entries.begin() + slots[slot].entry, false};
+
+        //keep at least half the slots empty, so searches stay short. The
+        //table only grows for a new key, and the key's slot moves if it does
+        if((entries.size() + 1) * 2 > slots.size()) {
+            rehash(bits < 4 ? 4 : bits + 1);
+            slot = probe(key);
+        }
+
+        entries.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        slots[slot] = Slot{key, static_cast<std::uint32_t>(entries.size() - 1)};
+        return {entries.end() - 1, true};
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(SymbolID key, Args&&... args) {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    /*
+      Make room for a number of entries without the table being rebuilt.
+    */
+    void reserve(size_type count) {
+        unsigned int newBits = bits < 4 ? 4 : bits;
+        while((std::size_t(1) << newBits) < count * 2)
+            newBits++;
+        if(newBits != bits)
+            rehash(newBits);
+    }
+
+    void clear() {
+        entries.clear();
+        slots.clear();
+        bits = 0;
+    }
+
+    /*----Iteration----*/
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    /*----Miscellaneous----*/
+    size_type size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    allocator_type get_allocator() const { return entries.get_allocator(); }
+};
+
+#endif // SYMBOLMAP_H_
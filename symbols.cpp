@@ -0,0 +1,252 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the implementation of the SymbolTable class. See the
+  header file for additional comments.
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "symbols.h"
+
+/*
+  Construct an empty SymbolTable. The empty string is interned straight away,
+  so that it is always ID 0 (e.g. the code of a default constructed Area).
+
+  @param denseIndex
+    If true, codes in the pattern of area codes (see decodeAreaCode()) are
+    kept in a dense index as well as the hash map
+
+  @example
+    SymbolTable codes;
+*/
+SymbolTable::SymbolTable(bool denseIndex) : hasDenseIndex(denseIndex) {
+    intern("");
+}
+
+/*
+  Decode a code in the pattern of UK statistical area codes: a capital
+  letter, a two digit entity type and a six digit number, e.g. W06000024.
+
+  @param text
+    The code
+
+  @param type
+    Set to the letter and entity type as a number from 0 (A00) to 2599 (Z99)
+
+  @param number
+    Set to the six digit number
+
+  @return
+    true if the code is in the pattern and its number is less than
+    DENSE_NUMBERS, false otherwise
+
+  @example
+    std::size_t type, number;
+    SymbolTable::decodeAreaCode("W06000024", type, number); // 2206 and 24
+*/
+bool SymbolTable::decodeAreaCode(std::string_view text, std::size_t& type, std::size_t& number) noexcept {
+    if(text.size() != 9 || text[0] < 'A' || text[0] > 'Z')
+        return false;
+
+    std::size_t digits = 0;
+    for(std::size_t i = 1; i < 9; i++) {
+        if(text[i] < '0' || text[i] > '9')
+            return false;
+        digits = digits * 10 + (text[i] - '0');
+    }
+
+    type = (text[0] - 'A') * 100 + digits / 1000000;
+    number = digits % 1000000;
+    return number < DENSE_NUMBERS;
+}
+
+/*
+  Look up a decoded code in the dense index. Must be called with the lock
+  held.
+
+  @param type
+    The letter and entity type, from decodeAreaCode()
+
+  @param number
+    The number, from decodeAreaCode()
+
+  @return
+    The ID of the code, or 0 if it has not been interned
+*/
+SymbolID SymbolTable::denseID(std::size_t type, std::size_t number) const {
+    if(type >= dense.size() || number >= dense[type].size())
+        return 0;
+    return dense[type][number];
+}
+
+/*
+  Get the ID for a string, adding the string to the table if it is not
+  already there.
+
+  @param text
+    The string to intern
+
+  @return
+    The ID of the string
+
+  @example
+    SymbolID id = SymbolTable::areas().intern("W06000011");
+*/
+SymbolID SymbolTable::intern(std::string_view text) {
+    std::size_t type, number;
+    bool isDense = hasDenseIndex && decodeAreaCode(text, type, number);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if(isDense) {
+            SymbolID id = denseID(type, number);
+            if(id != 0)
+                return id;
+        }else{
+            auto found = ids.find(text);
+            if(found != ids.end())
+                return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    //another thread may have added it while the lock was released
+    auto found = ids.find(text);
+    if(found != ids.end())
+        return found->second;
+
+    SymbolID id = strings.size();
+    strings.emplace_back(text);
+    ids.emplace(strings.back(), id);
+
+    if(isDense) {
+        if(type >= dense.size())
+            dense.resize(type + 1);
+        //the array grows like a vector, so it is rarely reallocated
+        if(number >= dense[type].size())
+            dense[type].resize(std::max(number + 1, std::min(dense[type].size() * 2, DENSE_NUMBERS)), 0);
+        dense[type][number] = id;
+    }
+    return id;
+}
+
+/*
+  Get the ID for a string without adding it to the table.
+
+  @param text
+    The string to look for
+
+  @param id
+    Set to the ID of the string, if it was found
+
+  @return
+    true if the string is in the table, false otherwise
+
+  @example
+    SymbolID id;
+    if(!SymbolTable::areas().find("W06000011", id))
+      throw std::out_of_range("No area found matching W06000011");
+*/
+bool SymbolTable::find(std::string_view text, SymbolID& id) const {
+    std::size_t type, number;
+    bool isDense = hasDenseIndex && decodeAreaCode(text, type, number);
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if(isDense) {
+        //every code in the pattern is in the dense index
+        id = denseID(type, number);
+        return id != 0;
+    }
+
+    auto found = ids.find(text);
+    if(found == ids.end())
+        return false;
+    id = found->second;
+    return true;
+}
+
+/*
+  Get the string for an ID.
+
+  @param id
+    An ID given out by this table
+
+  @return
+    The string
+
+  @throws
+    std::out_of_range if the ID was not given out by this table
+
+  @example
+    std::string code = SymbolTable::areas().name(id);
+*/
+const std::string& SymbolTable::name(SymbolID id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if(id >= strings.size())
+        throw std::out_of_range("No symbol with ID " + std::to_string(id));
+    return strings[id];
+}
+
+/*
+  Get the number of strings in the table, including the empty string.
+
+  @return
+    The number of strings
+
+  @example
+    auto codes = SymbolTable::areas().size();
+*/
+std::size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return strings.size();
+}
+
+/*
+  The table of local authority codes, which has a dense index for codes such
+  as W06000024.
+
+  @return
+    The shared table
+
+  @example
+    SymbolID id = SymbolTable::areas().intern("W06000011");
+*/
+SymbolTable& SymbolTable::areas() {
+    static SymbolTable table(true);
+    return table;
+}
+
+/*
+  The table of measure codes. Area keys its measures by the lower case code,
+  while each Measure keeps its code as it was given.
+
+  @return
+    The shared table
+
+  @example
+    SymbolID id = SymbolTable::measures().intern("pop");
+*/
+SymbolTable& SymbolTable::measures() {
+    static SymbolTable table;
+    return table;
+}
+
+/*
+  The table of language codes for the names of areas.
+
+  @return
+    The shared table
+
+  @example
+    SymbolID id = SymbolTable::languages().intern("eng");
+*/
+SymbolTable& SymbolTable::languages() {
+    static SymbolTable table;
+    return table;
+}
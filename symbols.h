@@ -0,0 +1,124 @@
+#ifndef SYMBOLS_H_
+#define SYMBOLS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  This file contains the declaration of the SymbolTable class, which interns
+  the codes used as keys throughout Beth Yw? (authority codes, measure codes
+  and language codes) as compact integer IDs.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+  The ID of an interned string. IDs are only meaningful within the
+  SymbolTable that gave them out.
+*/
+using SymbolID = std::uint32_t;
+
+/*
+  A SymbolTable gives each distinct string it is asked about a small integer
+  ID, starting from 0 (which is always the empty string) and counting up. The
+  string is stored once, in the table, and Area, Areas and Measure keep only
+  the ID, so comparing or looking up a code is an integer operation. The
+  string is only fetched back with name() when it is written out.
+
+  There is one table each for authority codes, measure codes and language
+  codes, shared by every Areas object. The tables are thread safe, as
+  datasets may be imported on several threads at once. IDs and the strings
+  returned by name() stay valid for the life of the program.
+
+  A table can also keep a dense index for codes in the pattern of UK
+  statistical area codes: a capital letter, then a two digit entity type,
+  then a six digit number (e.g. W06000024, or E01000001 for an LSOA). Such a
+  code is decoded straight into a slot of an array, one array per letter and
+  entity type, holding its ID, so looking it up never hashes or compares the
+  string. Anything else (or a number too large for the arrays) is looked up
+  in the hash map as usual. The table of authority codes has a dense index.
+*/
+class SymbolTable {
+private:
+    //guards strings and ids; lookups share it, new strings take it alone
+    mutable std::shared_mutex mutex;
+
+    //Index = ID | Value = the string (a deque, so strings never move)
+    std::deque<std::string> strings;
+
+    //Key = a view of a string in strings | Value = its ID
+    std::unordered_map<std::string_view, SymbolID> ids;
+
+    //if codes in the pattern of area codes are indexed in dense
+    bool hasDenseIndex;
+
+    //Index = letter and entity type (see decodeAreaCode()) |
+    // Value = (Index = number | Value = the ID, or 0 if not interned)
+    std::vector<std::vector<SymbolID>> dense;
+
+    /*----Helper----*/
+    SymbolID denseID(std::size_t type, std::size_t number) const;
+
+public:
+    //the number of slots in each array of the dense index can grow to;
+    //larger numbers are looked up in the hash map
+    static constexpr std::size_t DENSE_NUMBERS = std::size_t(1) << 18;
+
+    /*----Constructors----*/
+    explicit SymbolTable(bool denseIndex = false);
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /*----Lookup----*/
+    SymbolID intern(std::string_view text);
+    bool find(std::string_view text, SymbolID& id) const;
+    const std::string& name(SymbolID id) const;
+
+    /*----Miscellaneous----*/
+    std::size_t size() const;
+    static bool decodeAreaCode(std::string_view text, std::size_t& type, std::size_t& number) noexcept;
+
+    /*
+      The entries of a container keyed by IDs from this table, sorted by the
+      strings of their keys. Output is always written in string order, as it
+      was when the containers were keyed by the strings themselves.
+
+      @example
+        for(auto const* measure : SymbolTable::measures().sorted(measures))
+          writer.key(SymbolTable::measures().name(measure->first));
+    */
+    template<class Container>
+    std::vector<const typename Container::value_type*> sorted(const Container& container) const {
+        std::vector<std::pair<const std::string*, const typename Container::value_type*>> keyed;
+        keyed.reserve(container.size());
+        for(auto const& entry : container)
+            keyed.emplace_back(&name(entry.first), &entry);
+        std::sort(keyed.begin(), keyed.end(), [](auto const& lhs, auto const& rhs) {
+            return *lhs.first < *rhs.first;
+        });
+
+        std::vector<const typename Container::value_type*> entries;
+        entries.reserve(keyed.size());
+        for(auto const& entry : keyed)
+            entries.push_back(entry.second);
+        return entries;
+    }
+
+    /*----The shared tables----*/
+    static SymbolTable& areas();
+    static SymbolTable& measures();
+    static SymbolTable& languages();
+};
+
+#endif // SYMBOLS_H_
@@ -0,0 +1,105 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Compares the streaming (SAX) and document (DOM) WelshStatsJSON parsers on
+  popu1009.json with its "value" array repeated 100 times. Build and run with:
+
+    ./build.sh bench1
+    ./bin/bethyw-bench --benchmark-samples 10
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+
+/*
+  Read a WelshStatsJSON file and repeat the records in its "value" array
+  `times` times, to give a larger file with the same structure.
+*/
+static std::string scaleWelshStatsJSON(const std::string &path, unsigned int times) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string original = contents.str();
+
+  const std::string valueKey = "\"value\":[";
+  const size_t start = original.find(valueKey) + valueKey.size();
+  const size_t end   = original.rfind(']');
+  const std::string records = original.substr(start, end - start);
+
+  std::string scaled = original.substr(0, start);
+  scaled.reserve(original.size() * times);
+  for (unsigned int i = 0; i < times; i++) {
+    if (i > 0)
+      scaled += ',';
+    scaled += records;
+  }
+  scaled += original.substr(end);
+  return scaled;
+}
+
+TEST_CASE( "WelshStatsJSON parsing of popu1009.json scaled 100x", "[benchmark][Areas][popu1009]" ) {
+
+  static const std::string scaled = scaleWelshStatsJSON("datasets/popu1009.json", 100);
+  const std::string_view buffer = scaled;
+
+  std::unordered_set<std::string> areasFilter(0);
+  std::unordered_set<std::string> measuresFilter(0);
+  std::tuple<unsigned int, unsigned int> yearsFilter = std::make_tuple(0,0);
+  const auto &cols = BethYw::InputFiles::POPDEN.COLS;
+
+  Areas streamed;
+  Areas document;
+  Areas scanned;
+  document.setJSONMode(WelshStatsJSONMode::Document);
+  scanned.setJSONMode(WelshStatsJSONMode::Scanner);
+  streamed.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+  document.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+  scanned.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+  REQUIRE( streamed.toJSON() == document.toJSON() );
+  REQUIRE( streamed.toJSON() == scanned.toJSON() );
+
+  BENCHMARK( "document (DOM)" ) {
+    Areas areas;
+    areas.setJSONMode(WelshStatsJSONMode::Document);
+    areas.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.size();
+  };
+
+  BENCHMARK( "streaming (SAX)" ) {
+    Areas areas;
+    areas.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.size();
+  };
+
+  BENCHMARK( "scanner (ODataScanner)" ) {
+    Areas areas;
+    areas.setJSONMode(WelshStatsJSONMode::Scanner);
+    areas.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.size();
+  };
+
+  BENCHMARK( "scanner (ODataScanner) on 4 threads" ) {
+    Areas areas;
+    areas.setJSONMode(WelshStatsJSONMode::Scanner);
+    areas.setThreads(4);
+    areas.populateFromWelshStatsJSON(buffer, cols, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.size();
+  };
+
+}
@@ -0,0 +1,279 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Benchmarks for the hot paths of Beth Yw?: opening files, each populate
+  parser, merging measures, looking up areas, the Measure statistics and the
+  JSON and table output. Each is run on the bundled datasets and on larger inputs from the
+  DatasetGenerator. Build and run with:
+
+    ./build.sh bench
+    ./bin/bethyw-bench --benchmark-samples 20
+    ./bin/bethyw-bench --benchmark-samples 20 -r json -o bench.json
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../csv.h"
+#include "../generator.h"
+#include "../input.h"
+
+/*
+  Read a file from the datasets directory into memory.
+*/
+static std::string readDataset(const std::string &file) {
+  std::ifstream is(std::string("datasets") + DIR_SEP + file, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+}
+
+/*
+  Generate a file for a dataset into memory.
+*/
+static std::string generateDataset(const BethYw::InputFileSource &source,
+                                   unsigned int areas,
+                                   unsigned int measures,
+                                   unsigned int years) {
+  DatasetGenerator generator(areas, measures, years);
+  std::ostringstream os;
+  generator.write(os, source);
+  return os.str();
+}
+
+/*
+  Import every bundled dataset for the areas in areas.csv. Only these areas
+  have both an English and a Welsh name, which operator<< needs.
+*/
+static Areas importBundled() {
+  std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+  const std::string areasCSV = readDataset(BethYw::InputFiles::AREAS.FILE);
+  StringFilterSet areasFilter(0);
+  CSVTokenizer csv(areasCSV);
+  std::string_view code;
+  csv.nextRow();
+  while (csv.nextRow())
+    if (csv.nextField(code) && !code.empty())
+      areasFilter.emplace(code);
+
+  StringFilterSet measuresFilter(0);
+  YearFilterTuple yearsFilter = std::make_tuple(0,0);
+
+  Areas areas;
+  BethYw::loadAreas(areas, std::string("datasets") + DIR_SEP, areasFilter);
+  BethYw::loadDatasets(areas, std::string("datasets") + DIR_SEP, datasets, areasFilter, measuresFilter, yearsFilter);
+  return areas;
+}
+
+/*
+  Populate a new Areas instance from a file in memory, parsing it with up to
+  the given number of threads.
+*/
+static Areas populate(const std::string &contents, const BethYw::InputFileSource &source, unsigned int threads = 1) {
+  Areas areas;
+  areas.setThreads(threads);
+  areas.populate(std::string_view(contents), source.PARSER, source.COLS);
+  return areas;
+}
+
+/*
+  Import a generated areas.csv and WelshStatsJSON file with the same areas.
+*/
+static Areas importGenerated(unsigned int areas, unsigned int measures, unsigned int years) {
+  const std::string areasCSV = generateDataset(BethYw::InputFiles::AREAS, areas, 1, 1);
+  const std::string popdenJSON = generateDataset(BethYw::InputFiles::POPDEN, areas, measures, years);
+
+  Areas data = populate(areasCSV, BethYw::InputFiles::AREAS);
+  data.populate(std::string_view(popdenJSON), BethYw::InputFiles::POPDEN.PARSER, BethYw::InputFiles::POPDEN.COLS);
+  return data;
+}
+
+TEST_CASE( "Opening input files", "[benchmark][InputFile]" ) {
+
+  const std::string path = std::string("datasets") + DIR_SEP + BethYw::InputFiles::POPDEN.FILE;
+
+  BENCHMARK( "InputFile::open and read popu1009.json" ) {
+    InputFile input(path);
+    std::istream &is = input.open();
+    std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    return contents.size();
+  };
+
+  BENCHMARK( "MappedInputFile::open popu1009.json" ) {
+    MappedInputFile input(path);
+    std::string_view contents = input.open();
+    return contents.size() + contents.back();
+  };
+
+}
+
+TEST_CASE( "Parsing the bundled datasets", "[benchmark][Areas][populate]" ) {
+
+  static const std::string areasCSV = readDataset(BethYw::InputFiles::AREAS.FILE);
+  static const std::string popdenJSON = readDataset(BethYw::InputFiles::POPDEN.FILE);
+  static const std::string popCSV = readDataset(BethYw::InputFiles::COMPLETE_POP.FILE);
+
+  BENCHMARK( "populateFromAuthorityCodeCSV areas.csv" ) {
+    return populate(areasCSV, BethYw::InputFiles::AREAS).size();
+  };
+
+  BENCHMARK( "populateFromWelshStatsJSON popu1009.json" ) {
+    return populate(popdenJSON, BethYw::InputFiles::POPDEN).size();
+  };
+
+  BENCHMARK( "populateFromAuthorityByYearCSV complete-popu1009-pop.csv" ) {
+    return populate(popCSV, BethYw::InputFiles::COMPLETE_POP).size();
+  };
+
+}
+
+TEST_CASE( "Parsing generated datasets", "[benchmark][Areas][populate][generated]" ) {
+
+  static const std::string areasCSV = generateDataset(BethYw::InputFiles::AREAS, 100000, 1, 1);
+  static const std::string popdenJSON = generateDataset(BethYw::InputFiles::POPDEN, 100, 10, 20);
+  static const std::string popCSV = generateDataset(BethYw::InputFiles::COMPLETE_POP, 5000, 1, 50);
+
+  BENCHMARK( "populateFromAuthorityCodeCSV 100000 areas" ) {
+    return populate(areasCSV, BethYw::InputFiles::AREAS).size();
+  };
+
+  BENCHMARK( "populateFromAuthorityCodeCSV 100000 areas on 4 threads" ) {
+    return populate(areasCSV, BethYw::InputFiles::AREAS, 4).size();
+  };
+
+  BENCHMARK( "populateFromWelshStatsJSON 20000 records" ) {
+    return populate(popdenJSON, BethYw::InputFiles::POPDEN).size();
+  };
+
+  BENCHMARK( "populateFromAuthorityByYearCSV 5000 areas x 50 years" ) {
+    return populate(popCSV, BethYw::InputFiles::COMPLETE_POP).size();
+  };
+
+  BENCHMARK( "populateFromAuthorityByYearCSV 5000 areas x 50 years on 4 threads" ) {
+    return populate(popCSV, BethYw::InputFiles::COMPLETE_POP, 4).size();
+  };
+
+  BENCHMARK( "CSVTokenizer every field of 5000 areas x 50 years" ) {
+    CSVTokenizer csv(popCSV);
+    std::string_view field;
+    std::size_t fields = 0;
+    while (csv.nextRow())
+      while (csv.nextField(field))
+        fields++;
+    return fields;
+  };
+
+}
+
+TEST_CASE( "Merging measures", "[benchmark][Area][Measure]" ) {
+
+  std::vector<Measure> measures;
+  for (unsigned int i = 0; i < 100; i++) {
+    Measure measure(DatasetGenerator::measureCode(i), "Measure");
+    for (unsigned int year = 1971; year <= 2020; year++)
+      measure.setValue(year, year * 1.5);
+    measures.push_back(measure);
+  }
+
+  Measure older("pop", "Population");
+  Measure newer("pop", "Population");
+  for (unsigned int year = 1000; year <= 2020; year++) {
+    if (year % 2 == 0)
+      older.setValue(year, year);
+    else
+      newer.setValue(year, year);
+  }
+
+  BENCHMARK( "Area::setMeasure 100 new then 100 existing measures" ) {
+    Area area("W06000011");
+    for (int pass = 0; pass < 2; pass++)
+      for (auto const &measure : measures)
+        area.setMeasure(measure.getCodename(), measure);
+    return area.size();
+  };
+
+  BENCHMARK( "Measure::merge two interleaved 1021 year measures" ) {
+    Measure merged = newer;
+    merged.merge(older);
+    return merged.size();
+  };
+
+}
+
+TEST_CASE( "Looking up areas", "[benchmark][Areas][lookup]" ) {
+
+  static const std::string areasCSV = generateDataset(BethYw::InputFiles::AREAS, 20000, 1, 1);
+  static Areas areas = populate(areasCSV, BethYw::InputFiles::AREAS);
+
+  std::vector<std::string> codes;
+  for (unsigned int area = 0; area < 20000; area += 7)
+    codes.push_back(DatasetGenerator::areaCode(area));
+
+  BENCHMARK( "Areas::getArea 2858 codes of 20000" ) {
+    std::size_t names = 0;
+    for (auto const &code : codes)
+      names += areas.getArea(code).getName("eng").size();
+    return names;
+  };
+
+}
+
+TEST_CASE( "Measure statistics", "[benchmark][Measure]" ) {
+
+  Measure measure("pop", "Population");
+  for (unsigned int year = 1000; year <= 2020; year++)
+    measure.setValue(year, year * 0.5);
+
+  BENCHMARK( "Measure::getAverage 1021 years" ) {
+    return measure.getAverage();
+  };
+
+  BENCHMARK( "Measure::getDifferenceAsPercentage 1021 years" ) {
+    return measure.getDifferenceAsPercentage();
+  };
+
+}
+
+TEST_CASE( "Writing output", "[benchmark][Areas][output]" ) {
+
+  static const Areas bundled = importBundled();
+  static const Areas generated = importGenerated(100, 10, 20);
+
+  BENCHMARK( "Areas::toJSON bundled datasets" ) {
+    return bundled.toJSON().size();
+  };
+
+  BENCHMARK( "Areas::toJSON 20000 generated records" ) {
+    return generated.toJSON().size();
+  };
+
+  BENCHMARK( "operator<< bundled datasets" ) {
+    std::ostringstream os;
+    os << bundled;
+    return os.str().size();
+  };
+
+  BENCHMARK( "operator<< 20000 generated records" ) {
+    std::ostringstream os;
+    os << generated;
+    return os.str().size();
+  };
+
+}
@@ -0,0 +1,16 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  All of the benchmarks, built with ./build.sh bench
+ */
+
+#include "benchjson.cpp"
+#include "bench1.cpp"
+#include "bench2.cpp"
@@ -0,0 +1,94 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  A Catch2 reporter that writes benchmark results as JSON, so results can be
+  saved and compared between commits. Select it with -r json, e.g.
+
+    ./bin/bethyw-bench -r json -o bench.json
+
+  The report has one entry per BENCHMARK, with times in nanoseconds:
+    {"benchmarks":[{"testCase":...,"name":...,"samples":...,
+                    "iterations":...,"meanNs":...,"meanLowNs":...,
+                    "meanHighNs":...,"standardDeviationNs":...,
+                    "outlierVariance":...}, ...]}
+
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "../jsonwriter.h"
+
+class JSONBenchmarkReporter : public Catch::StreamingReporterBase<JSONBenchmarkReporter> {
+private:
+  struct Result {
+    std::string testCase;
+    Catch::BenchmarkStats<> stats;
+  };
+
+  std::vector<Result> results;
+
+public:
+  using StreamingReporterBase::StreamingReporterBase;
+
+  static std::string getDescription() {
+    return "Reports benchmark results as JSON";
+  }
+
+  void assertionStarting(Catch::AssertionInfo const &) override {}
+
+  bool assertionEnded(Catch::AssertionStats const &) override {
+    return true;
+  }
+
+  void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+    results.push_back({currentTestCaseInfo->name, stats});
+  }
+
+  void testRunEnded(Catch::TestRunStats const &testRunStats) override {
+    JSONWriter writer(stream);
+
+    writer.beginObject();
+    writer.key("benchmarks");
+    writer.beginArray();
+    for (auto const &result : results) {
+      writer.beginObject();
+      writer.key("testCase");
+      writer.value(result.testCase);
+      writer.key("name");
+      writer.value(result.stats.info.name);
+      writer.key("samples");
+      writer.value(static_cast<std::uint64_t>(result.stats.samples.size()));
+      writer.key("iterations");
+      writer.value(static_cast<std::uint64_t>(result.stats.info.iterations));
+      writer.key("meanNs");
+      writer.value(result.stats.mean.point.count());
+      writer.key("meanLowNs");
+      writer.value(result.stats.mean.lower_bound.count());
+      writer.key("meanHighNs");
+      writer.value(result.stats.mean.upper_bound.count());
+      writer.key("standardDeviationNs");
+      writer.value(result.stats.standardDeviation.point.count());
+      writer.key("outlierVariance");
+      writer.value(result.stats.outlierVariance);
+      writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    stream << std::endl;
+
+    StreamingReporterBase::testRunEnded(testRunStats);
+  }
+};
+
+CATCH_REGISTER_REPORTER("json", JSONBenchmarkReporter)
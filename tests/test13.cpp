@@ -0,0 +1,136 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+SCENARIO( "a source file can be memory mapped", "[MappedInputFile][existent]" ) {
+
+  auto read_file = [](const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+  };
+
+  const std::string test_file = "datasets/areas.csv";
+
+  GIVEN( "a constructed MappedInputFile instance" ) {
+
+    MappedInputFile input(test_file);
+
+    THEN( "the source value can be retrieved" ) {
+
+      REQUIRE( input.getSource() == test_file );
+
+    } // THEN
+
+    THEN( "the file can be mapped without exception" ) {
+
+      REQUIRE_NOTHROW( input.open() );
+
+      AND_THEN( "the view contains exactly the bytes of the file" ) {
+
+        REQUIRE( input.open() == read_file(test_file) );
+        REQUIRE( input.view() == read_file(test_file) );
+
+      } // AND_THEN
+
+      AND_THEN( "a stream over the mapped bytes can be read and seeked" ) {
+
+        std::istream &stream = input.openStream();
+        std::string line;
+
+        REQUIRE( std::getline(stream, line) );
+        REQUIRE( line == "Local authority code,Name (eng),Name (cym)" );
+        REQUIRE_NOTHROW( stream.seekg(1, stream.beg) );
+        REQUIRE_FALSE( stream.eof() );
+        REQUIRE( stream.tellg() == 1 );
+
+      } // AND_THEN
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a MappedInputFile for a path that does not exist" ) {
+
+    const std::string missing_file = "datasets/jibberish.json";
+    MappedInputFile input(missing_file);
+
+    const std::string exceptionMessage = "MappedInputFile::open: Failed to open file " + missing_file;
+
+    THEN( "mapping it throws a std::runtime_error with message " + exceptionMessage ) {
+
+      REQUIRE_THROWS_AS( input.open(), std::runtime_error );
+      REQUIRE_THROWS_WITH( input.open(), exceptionMessage );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Areas can be populated directly from mapped files", "[Areas][MappedInputFile]" ) {
+
+  std::unordered_set<std::string> areasFilter(0);
+  std::unordered_set<std::string> measuresFilter(0);
+  std::tuple<unsigned int, unsigned int> yearsFilter = std::make_tuple(0,0);
+
+  auto populate_from_stream = [&](const BethYw::InputFileSource &source) {
+    Areas areas;
+    std::ifstream stream("datasets/" + source.FILE);
+    areas.populate(stream, source.PARSER, source.COLS, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.toJSON();
+  };
+
+  auto populate_from_mapping = [&](const BethYw::InputFileSource &source) {
+    Areas areas;
+    MappedInputFile input("datasets/" + source.FILE);
+    areas.populate(input.open(), source.PARSER, source.COLS, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.toJSON();
+  };
+
+  GIVEN( "the areas.csv file" ) {
+
+    THEN( "the mapped file produces the same Areas as the stream" ) {
+
+      REQUIRE( populate_from_mapping(BethYw::InputFiles::AREAS) == populate_from_stream(BethYw::InputFiles::AREAS) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "each of the datasets" ) {
+
+    THEN( "each mapped file produces the same Areas as the stream" ) {
+
+      for (unsigned int i = 0; i < BethYw::InputFiles::NUM_DATASETS; i++) {
+        auto &source = BethYw::InputFiles::DATASETS[i];
+        INFO( source.FILE );
+        REQUIRE( populate_from_mapping(source) == populate_from_stream(source) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,95 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+
+SCENARIO( "WelshStatsJSON files parse the same when streamed as when read as a document", "[Areas][WelshStatsJSON][streaming]" ) {
+
+  auto populate = [](const BethYw::InputFileSource &source,
+                     WelshStatsJSONMode mode,
+                     const StringFilterSet &areasFilter,
+                     const StringFilterSet &measuresFilter,
+                     const YearFilterTuple &yearsFilter) {
+    Areas areas;
+    areas.setJSONMode(mode);
+    std::ifstream stream("datasets/" + source.FILE);
+    areas.populateFromWelshStatsJSON(stream, source.COLS, &areasFilter, &measuresFilter, &yearsFilter);
+    return areas.toJSON();
+  };
+
+  const BethYw::InputFileSource sources[] = { BethYw::InputFiles::POPDEN,
+                                              BethYw::InputFiles::BIZ,
+                                              BethYw::InputFiles::AQI,
+                                              BethYw::InputFiles::TRAINS };
+
+  GIVEN( "empty filters" ) {
+
+    StringFilterSet areasFilter(0);
+    StringFilterSet measuresFilter(0);
+    YearFilterTuple yearsFilter = std::make_tuple(0,0);
+
+    THEN( "each JSON dataset produces the same Areas in both modes" ) {
+
+      for (auto &source : sources) {
+        INFO( source.FILE );
+        REQUIRE( populate(source, WelshStatsJSONMode::Streaming, areasFilter, measuresFilter, yearsFilter) ==
+                 populate(source, WelshStatsJSONMode::Document, areasFilter, measuresFilter, yearsFilter) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an areas, measures and years filter" ) {
+
+    StringFilterSet areasFilter({"W06000011", "W06000024"});
+    StringFilterSet measuresFilter({"dens", "rail", "a"});
+    YearFilterTuple yearsFilter = std::make_tuple(2005, 2015);
+
+    THEN( "each JSON dataset produces the same Areas in both modes" ) {
+
+      for (auto &source : sources) {
+        INFO( source.FILE );
+        REQUIRE( populate(source, WelshStatsJSONMode::Streaming, areasFilter, measuresFilter, yearsFilter) ==
+                 populate(source, WelshStatsJSONMode::Document, areasFilter, measuresFilter, yearsFilter) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a malformed JSON document" ) {
+
+    std::istringstream stream("{\"value\":[{\"Localauthority_Code\":\"W06000001\",");
+    StringFilterSet areasFilter(0);
+    StringFilterSet measuresFilter(0);
+    YearFilterTuple yearsFilter = std::make_tuple(0,0);
+
+    THEN( "the streaming parser throws a parse error, as the document parser does" ) {
+
+      Areas areas;
+      REQUIRE_THROWS_AS( areas.populateFromWelshStatsJSON(stream, BethYw::InputFiles::POPDEN.COLS, &areasFilter, &measuresFilter, &yearsFilter), nlohmann::json::parse_error );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,130 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "../csv.h"
+
+SCENARIO( "CSV text can be split into rows and fields", "[CSVTokenizer]" ) {
+
+  auto tokenize = [](std::string_view text) {
+    std::vector<std::vector<std::string>> rows;
+    CSVTokenizer csv(text);
+    std::string_view field;
+    while (csv.nextRow()) {
+      rows.emplace_back();
+      while (csv.nextField(field))
+        rows.back().emplace_back(field);
+    }
+    return rows;
+  };
+
+  using Rows = std::vector<std::vector<std::string>>;
+
+  GIVEN( "unquoted fields over several lines" ) {
+
+    THEN( "each line is a row and each comma separates a field" ) {
+
+      REQUIRE( tokenize("give,me,100%,please") == Rows({{"give", "me", "100%", "please"}}) );
+      REQUIRE( tokenize("a,b\nc,d\n") == Rows({{"a", "b"}, {"c", "d"}}) );
+      REQUIRE( tokenize("a,b\r\nc,d") == Rows({{"a", "b"}, {"c", "d"}}) );
+
+    } // THEN
+
+    THEN( "empty fields and blank lines are kept" ) {
+
+      REQUIRE( tokenize("a,,c,") == Rows({{"a", "", "c", ""}}) );
+      REQUIRE( tokenize("a\n\nb") == Rows({{"a"}, {""}, {"b"}}) );
+
+    } // THEN
+
+    THEN( "empty text has no rows" ) {
+
+      REQUIRE( tokenize("").empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "quoted fields" ) {
+
+    THEN( "commas, new lines and escaped quotes inside quotes are part of the field" ) {
+
+      REQUIRE( tokenize("\"Newport, Gwent\",x") == Rows({{"Newport, Gwent", "x"}}) );
+      REQUIRE( tokenize("\"two\nlines\",x\ny") == Rows({{"two\nlines", "x"}, {"y"}}) );
+      REQUIRE( tokenize("\"say \"\"hello\"\"\",\"\"") == Rows({{"say \"hello\"", ""}}) );
+
+    } // THEN
+
+    THEN( "a quoted field without escapes is a view into the original text" ) {
+
+      const std::string text = "\"abc\",def";
+      CSVTokenizer csv(text);
+      std::string_view field;
+      csv.nextRow();
+      csv.nextField(field);
+
+      REQUIRE( field == "abc" );
+      REQUIRE( field.data() == text.data() + 1 );
+
+    } // THEN
+
+    THEN( "a malformed quoted field throws a std::runtime_error" ) {
+
+      REQUIRE_THROWS_AS( tokenize("\"never closed,a"), std::runtime_error );
+      REQUIRE_THROWS_AS( tokenize("\"closed\"early,a"), std::runtime_error );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a row whose fields are not all read" ) {
+
+    CSVTokenizer csv("a,b,c\nd,e");
+    std::string_view field;
+
+    THEN( "nextRow() skips the rest of the row" ) {
+
+      REQUIRE( csv.nextRow() );
+      REQUIRE( csv.nextField(field) );
+      REQUIRE( field == "a" );
+      REQUIRE( csv.nextRow() );
+      REQUIRE( csv.nextField(field) );
+      REQUIRE( field == "d" );
+      REQUIRE( csv.nextField(field) );
+      REQUIRE( field == "e" );
+      REQUIRE_FALSE( csv.nextField(field) );
+      REQUIRE_FALSE( csv.nextRow() );
+
+    } // THEN
+
+    THEN( "nextRow() skips quoted fields holding new lines in the rest of the row" ) {
+
+      CSVTokenizer quoted("a,\"b\nstill b\",c\r\nd");
+      REQUIRE( quoted.nextRow() );
+      REQUIRE( quoted.nextField(field) );
+      REQUIRE( field == "a" );
+      REQUIRE( quoted.nextRow() );
+      REQUIRE( quoted.nextField(field) );
+      REQUIRE( field == "d" );
+      REQUIRE_FALSE( quoted.nextRow() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,111 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "../lib_cxxopts.hpp"
+#include "../lib_cxxopts_argv.hpp"
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+
+SCENARIO( "the threads program argument can be parsed correctly", "[args][threads]" ) {
+
+  GIVEN( "a --threads program argument and value" ) {
+
+    WHEN( "the value is a number ('3')" ) {
+
+      Argv argv({"test", "--threads", "3"});
+      auto** actual_argv = argv.argv();
+      auto argc          = argv.argc();
+
+      auto cxxopts = BethYw::cxxoptsSetup();
+      auto args    = cxxopts.parse(argc, actual_argv);
+
+      THEN( "the response is that number" ) {
+
+        REQUIRE( BethYw::parseThreadsArg(args) == 3 );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "the value is 0" ) {
+
+      Argv argv({"test", "--threads", "0"});
+      auto** actual_argv = argv.argv();
+      auto argc          = argv.argc();
+
+      auto cxxopts = BethYw::cxxoptsSetup();
+      auto args    = cxxopts.parse(argc, actual_argv);
+
+      THEN( "at least one thread is used" ) {
+
+        REQUIRE( BethYw::parseThreadsArg(args) >= 1 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "datasets imported on several threads match datasets imported one after another", "[loadDatasets][threads]" ) {
+
+  auto load = [](unsigned int threads,
+                 const StringFilterSet &areasFilter,
+                 const StringFilterSet &measuresFilter,
+                 const YearFilterTuple &yearsFilter) {
+    std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                  BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+    Areas areas;
+    BethYw::loadAreas(areas, std::string("datasets") + DIR_SEP, areasFilter);
+    BethYw::loadDatasets(areas, std::string("datasets") + DIR_SEP, datasets, areasFilter, measuresFilter, yearsFilter, threads);
+    return areas.toJSON();
+  };
+
+  GIVEN( "all of the datasets and no filters" ) {
+
+    StringFilterSet areasFilter(0);
+    StringFilterSet measuresFilter(0);
+    YearFilterTuple yearsFilter = std::make_tuple(0,0);
+
+    THEN( "importing with 4 threads gives the same Areas as with 1" ) {
+
+      REQUIRE( load(4, areasFilter, measuresFilter, yearsFilter) == load(1, areasFilter, measuresFilter, yearsFilter) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "all of the datasets and some filters" ) {
+
+    StringFilterSet areasFilter({"W06000011", "W06000024", "W92000004"});
+    StringFilterSet measuresFilter(0);
+    YearFilterTuple yearsFilter = std::make_tuple(2005, 2015);
+
+    THEN( "importing with 3 threads gives the same Areas as with 1" ) {
+
+      REQUIRE( load(3, areasFilter, measuresFilter, yearsFilter) == load(1, areasFilter, measuresFilter, yearsFilter) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
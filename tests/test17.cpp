@@ -0,0 +1,124 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "../lib_json.hpp"
+
+#include "../jsonwriter.h"
+#include "../measure.h"
+#include "../area.h"
+#include "../areas.h"
+
+using json = nlohmann::json;
+
+SCENARIO( "JSON written by a JSONWriter matches nlohmann::json", "[JSONWriter]" ) {
+
+  GIVEN( "a JSONWriter writing to a string stream" ) {
+
+    std::ostringstream os;
+    JSONWriter writer(os);
+
+    THEN( "numbers are formatted the same way" ) {
+
+      const double numbers[] = {0, 5, -0.0, 0.1, 1.0 / 3, 12345679.9, 1e300, 1e-7,
+                                std::numeric_limits<double>::quiet_NaN()};
+      json expected = json::object();
+
+      writer.beginObject();
+      for (unsigned int i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+        writer.key(std::to_string(i));
+        writer.value(numbers[i]);
+        expected[std::to_string(i)] = numbers[i];
+      }
+      writer.endObject();
+
+      REQUIRE( os.str() == expected.dump() );
+
+    } // THEN
+
+    THEN( "strings are escaped the same way" ) {
+
+      const std::string text = "say \"hi\"\\ \n\t\r\b\f \x01\x1f Ynys Môn";
+      json expected;
+      expected[text]["nested"] = text;
+
+      writer.beginObject();
+      writer.key(text);
+      writer.beginObject();
+      writer.key("nested");
+      writer.value(text);
+      writer.endObject();
+      writer.endObject();
+
+      REQUIRE( os.str() == expected.dump() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Measure, Area and Areas instances" ) {
+
+    Measure measure("pop", "Population");
+    Area area("W06000023");
+
+    THEN( "an empty Measure or Area is written as null" ) {
+
+      REQUIRE( measure.toJSON() == "null" );
+      REQUIRE( area.toJSON() == "null" );
+
+    } // THEN
+
+    THEN( "a populated Area is written the same as the equivalent json document" ) {
+
+      measure.setValue(2011, 1);
+      measure.setValue(2010, 2.5);
+      area.setName("eng", "Powys");
+      area.setName("cym", "Powys");
+      area.setMeasure("pop", measure);
+      area.setMeasure("dens", Measure("dens", "Density"));
+
+      json expected;
+      expected["names"]["eng"] = "Powys";
+      expected["names"]["cym"] = "Powys";
+      expected["measures"]["pop"]["2010"] = 2.5;
+      expected["measures"]["pop"]["2011"] = 1.0;
+      expected["measures"]["dens"] = nullptr;
+
+      REQUIRE( area.toJSON() == expected.dump() );
+
+      Areas areas;
+      areas.setArea("W06000023", area);
+
+      std::ostringstream os;
+      areas.writeJSON(os);
+
+      REQUIRE( os.str() == "{\"W06000023\":" + expected.dump() + "}" );
+      REQUIRE( areas.toJSON() == os.str() );
+
+    } // THEN
+
+    THEN( "an empty Areas is written as an empty object" ) {
+
+      REQUIRE( Areas().toJSON() == "{}" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,223 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../snapshot.h"
+
+SCENARIO( "imported Areas can be saved to and loaded from a snapshot", "[Snapshot]" ) {
+
+  const std::string dir  = std::string("datasets") + DIR_SEP;
+  const std::string path = "test18.snapshot";
+  std::remove(path.c_str());
+
+  std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+  StringFilterSet areasFilter(0);
+  StringFilterSet measuresFilter(0);
+  YearFilterTuple yearsFilter = std::make_tuple(0,0);
+
+  const std::string key = BethYw::snapshotKey(dir, datasets, areasFilter, measuresFilter, yearsFilter);
+
+  GIVEN( "the key for all of the datasets" ) {
+
+    THEN( "the key is not empty" ) {
+
+      REQUIRE_FALSE( key.empty() );
+
+    } // THEN
+
+    THEN( "the key changes when a filter changes" ) {
+
+      StringFilterSet otherAreas({"W06000011"});
+      YearFilterTuple otherYears = std::make_tuple(2010, 2011);
+
+      REQUIRE( BethYw::snapshotKey(dir, datasets, areasFilter, measuresFilter, yearsFilter) == key );
+      REQUIRE( BethYw::snapshotKey(dir, datasets, otherAreas, measuresFilter, yearsFilter) != key );
+      REQUIRE( BethYw::snapshotKey(dir, datasets, areasFilter, measuresFilter, otherYears) != key );
+
+    } // THEN
+
+    THEN( "the key is empty if a source file is missing" ) {
+
+      REQUIRE( BethYw::snapshotKey("doesnotexist", datasets, areasFilter, measuresFilter, yearsFilter).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a snapshot of all of the datasets" ) {
+
+    Areas imported;
+    BethYw::loadAreas(imported, dir, areasFilter);
+    BethYw::loadDatasets(imported, dir, datasets, areasFilter, measuresFilter, yearsFilter);
+
+    Snapshot snapshot(path);
+    snapshot.save(imported, key);
+
+    THEN( "loading it with the same key gives the same Areas" ) {
+
+      Areas loaded;
+
+      REQUIRE( snapshot.load(loaded, key) );
+      REQUIRE( loaded.size() == imported.size() );
+      REQUIRE( loaded.toJSON() == imported.toJSON() );
+
+    } // THEN
+
+    THEN( "loading it with a different key fails and leaves the Areas unchanged" ) {
+
+      Areas loaded;
+
+      REQUIRE_FALSE( snapshot.load(loaded, key + "x") );
+      REQUIRE( loaded.size() == 0 );
+
+    } // THEN
+
+    THEN( "loading a damaged snapshot fails" ) {
+
+      std::ofstream(path, std::ios::binary | std::ios::app) << "extra";
+      Areas loaded;
+
+      REQUIRE_FALSE( snapshot.load(loaded, key) );
+
+      std::ofstream(path, std::ios::binary | std::ios::trunc) << "BYWSNAP";
+
+      REQUIRE_FALSE( snapshot.load(loaded, key) );
+      REQUIRE( loaded.size() == 0 );
+
+    } // THEN
+
+    std::remove(path.c_str());
+
+  } // GIVEN
+
+  GIVEN( "a snapshot of a copy of areas.csv and one dataset" ) {
+
+    const std::string copyDir = std::string("test18-sources") + DIR_SEP;
+    std::filesystem::create_directories(copyDir);
+    for (auto const &file : {BethYw::InputFiles::AREAS.FILE, BethYw::InputFiles::POPDEN.FILE})
+      std::filesystem::copy_file(dir + file, copyDir + file, std::filesystem::copy_options::overwrite_existing);
+
+    std::vector<BethYw::InputFileSource> popden = {BethYw::InputFiles::POPDEN};
+    const std::string copyKey = BethYw::snapshotKey(copyDir, popden, areasFilter, measuresFilter, yearsFilter);
+    const std::vector<std::string> sources = BethYw::snapshotSources(copyDir, popden);
+    const std::string datasetPath = sources.back();
+    REQUIRE( sources.size() == 2 );
+
+    Snapshot saving(path, sources);
+    Areas imported;
+    BethYw::loadAreas(imported, copyDir, areasFilter);
+    BethYw::loadDatasets(imported, copyDir, popden, areasFilter, measuresFilter, yearsFilter);
+    saving.save(imported, copyKey);
+
+    const auto modified = std::filesystem::last_write_time(datasetPath);
+    auto rewrite = [&](const std::string &contents) {
+      std::ofstream(datasetPath, std::ios::binary | std::ios::trunc) << contents;
+      std::filesystem::last_write_time(datasetPath, modified + std::chrono::hours(1));
+    };
+    std::string contents;
+    {
+      std::ifstream file(datasetPath, std::ios::binary);
+      contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    THEN( "it loads while the source files are unchanged" ) {
+
+      Areas loaded;
+      REQUIRE( Snapshot(path, sources).load(loaded, copyKey) );
+      REQUIRE( loaded.toJSON() == imported.toJSON() );
+
+    } // THEN
+
+    THEN( "it still loads after a source file is touched without changing it" ) {
+
+      rewrite(contents);
+      Areas loaded;
+      REQUIRE( Snapshot(path, sources).load(loaded, copyKey) );
+
+    } // THEN
+
+    THEN( "it does not load after a source file changes but keeps its size" ) {
+
+      std::string changed = contents;
+      const std::size_t digit = changed.find_first_of("123456789");
+      changed[digit] = changed[digit] == '9' ? '8' : '9';
+      rewrite(changed);
+      Areas loaded;
+      REQUIRE_FALSE( Snapshot(path, sources).load(loaded, copyKey) );
+      REQUIRE( loaded.size() == 0 );
+
+    } // THEN
+
+    THEN( "it does not load after a source file changes size" ) {
+
+      rewrite(contents + "\n");
+      Areas loaded;
+      REQUIRE_FALSE( Snapshot(path, sources).load(loaded, copyKey) );
+
+    } // THEN
+
+    THEN( "it is not saved if a source file changes while it is imported" ) {
+
+      Snapshot resaving(path, sources);
+      rewrite(contents);
+      REQUIRE_THROWS_AS( resaving.save(imported, copyKey), std::runtime_error );
+
+    } // THEN
+
+    std::remove(path.c_str());
+    std::filesystem::remove_all(copyDir);
+
+  } // GIVEN
+
+  GIVEN( "blocks of bytes that differ only a little" ) {
+
+    THEN( "their hashes differ" ) {
+
+      REQUIRE( Snapshot::hash("") != Snapshot::hash(std::string(1, '\0')) );
+      REQUIRE( Snapshot::hash("abcdefgh") != Snapshot::hash(std::string("abcdefgh\0", 9)) );
+      REQUIRE( Snapshot::hash("abcdefghi") != Snapshot::hash("abcdefghj") );
+      REQUIRE( Snapshot::hash("abcdefghijklmnop") != Snapshot::hash("abcdefghijklmnoq") );
+      REQUIRE( Snapshot::hash("abcdefghijklmnop") == Snapshot::hash("abcdefghijklmnop") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "no snapshot file" ) {
+
+    THEN( "loading fails" ) {
+
+      Areas loaded;
+
+      REQUIRE_FALSE( Snapshot(path).load(loaded, key) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
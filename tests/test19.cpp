@@ -0,0 +1,142 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../lib_json.hpp"
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../profile.h"
+
+SCENARIO( "Areas counts the rows it reads and accepts", "[Areas][ImportStats]" ) {
+
+  const std::string dir = std::string("datasets") + DIR_SEP;
+
+  GIVEN( "popu1009.json and filters for two areas, one measure and ten years" ) {
+
+    std::vector<BethYw::InputFileSource> datasets = {BethYw::InputFiles::POPDEN};
+    StringFilterSet areasFilter({"W06000011", "W06000024"});
+    StringFilterSet measuresFilter({"pop"});
+    YearFilterTuple yearsFilter = std::make_tuple(2001, 2010);
+
+    Areas areas;
+    BethYw::loadDatasets(areas, dir, datasets, areasFilter, measuresFilter, yearsFilter);
+    const ImportStats &stats = areas.getImportStats();
+
+    THEN( "every record is read, and each filter accepts fewer" ) {
+
+      REQUIRE( stats.rows == 1000 );
+      REQUIRE( stats.areasAccepted == 87 );
+      REQUIRE( stats.measuresAccepted == 29 );
+      REQUIRE( stats.readingsAccepted == 10 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "complete-popu1009-pop.csv and filters for two areas and 2001 to 2013" ) {
+
+    std::vector<BethYw::InputFileSource> datasets = {BethYw::InputFiles::COMPLETE_POP};
+    StringFilterSet areasFilter({"W06000011", "W06000024"});
+    StringFilterSet measuresFilter;
+    YearFilterTuple yearsFilter = std::make_tuple(2001, 2013);
+
+    Areas areas;
+    BethYw::loadDatasets(areas, dir, datasets, areasFilter, measuresFilter, yearsFilter);
+    const ImportStats &stats = areas.getImportStats();
+
+    THEN( "only the values of the accepted areas and years are read" ) {
+
+      REQUIRE( stats.areasAccepted == 2 );
+      REQUIRE( stats.readingsAccepted == 8 );
+      REQUIRE( areas.getArea("W06000011").getMeasure("pop").size() == 4 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "two Areas populated separately" ) {
+
+    StringFilterSet areasFilter(0);
+    Areas areas;
+    Areas shard;
+    BethYw::loadAreas(areas, dir, areasFilter);
+    BethYw::loadAreas(shard, dir, areasFilter);
+
+    THEN( "merging one into the other adds its counts" ) {
+
+      areas.merge(std::move(shard), BethYw::AuthorityCodeCSV);
+
+      REQUIRE( areas.getImportStats().rows == 44 );
+      REQUIRE( shard.getImportStats().rows == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a Profile report is written as JSON", "[Profile]" ) {
+
+  GIVEN( "a Profile of importing areas.csv and one dataset" ) {
+
+    Profile profile;
+    Areas areas;
+    StringFilterSet areasFilter(0);
+    StringFilterSet measuresFilter(0);
+    YearFilterTuple yearsFilter = std::make_tuple(0, 0);
+    std::vector<BethYw::InputFileSource> datasets = {BethYw::InputFiles::TRAINS};
+
+    profile.beginPhase("loadAreas");
+    BethYw::loadAreas(areas, std::string("datasets") + DIR_SEP, areasFilter, &profile);
+    profile.endPhase();
+
+    profile.beginPhase("loadDatasets");
+    BethYw::loadDatasets(areas, std::string("datasets") + DIR_SEP, datasets,
+                         areasFilter, measuresFilter, yearsFilter, 1, &profile);
+    profile.endPhase();
+
+    std::ostringstream os;
+    profile.write(os);
+    auto report = nlohmann::json::parse(os.str());
+
+    THEN( "the report lists each phase in order" ) {
+
+      REQUIRE( report["phases"].size() == 2 );
+      REQUIRE( report["phases"][0]["name"] == "loadAreas" );
+      REQUIRE( report["phases"][1]["name"] == "loadDatasets" );
+      REQUIRE( report["phases"][1]["seconds"] >= 0 );
+
+    } // THEN
+
+    THEN( "the report lists each file with its size and row counts" ) {
+
+      REQUIRE( report["datasets"].size() == 2 );
+      REQUIRE( report["datasets"][0]["file"] == "areas.csv" );
+      REQUIRE( report["datasets"][0]["rows"] == 22 );
+      REQUIRE( report["datasets"][1]["code"] == BethYw::InputFiles::TRAINS.CODE );
+      REQUIRE( report["datasets"][1]["bytes"] > 0 );
+      REQUIRE( report["datasets"][1]["rows"] > 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,143 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../generator.h"
+
+SCENARIO( "synthetic datasets can be generated and imported", "[DatasetGenerator]" ) {
+
+  auto import = [](DatasetGenerator &generator, const BethYw::InputFileSource &source) {
+    std::ostringstream file;
+    generator.write(file, source);
+    const std::string contents = file.str();
+
+    Areas areas;
+    areas.populate(std::string_view(contents), source.PARSER, source.COLS);
+    return areas;
+  };
+
+  GIVEN( "a generator for 5 areas, 3 measures and 4 years" ) {
+
+    DatasetGenerator generator(5, 3, 4);
+
+    WHEN( "an areas.csv file is generated and imported" ) {
+
+      Areas areas = import(generator, BethYw::InputFiles::AREAS);
+
+      THEN( "there is an Area for each area" ) {
+
+        REQUIRE( areas.size() == 5 );
+        REQUIRE( areas.getArea(DatasetGenerator::areaCode(4)).getName("cym") == "Ardal 5" );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a WelshStatsJSON file with several measures is generated and imported" ) {
+
+      Areas areas = import(generator, BethYw::InputFiles::BIZ);
+
+      THEN( "there is a reading for each area, measure and year, ending at 2020" ) {
+
+        REQUIRE( areas.size() == 5 );
+        REQUIRE( areas.getImportStats().readingsAccepted == 5 * 3 * 4 );
+
+        Area &area = areas.getArea(DatasetGenerator::areaCode(0));
+        REQUIRE( area.size() == 3 );
+        REQUIRE( area.getMeasure("m3").size() == 4 );
+        REQUIRE_NOTHROW( area.getMeasure("m1").getValue(2020) );
+        REQUIRE_THROWS_AS( area.getMeasure("m1").getValue(2016), std::out_of_range );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a WelshStatsJSON file with one field for the measure code and name is generated and imported" ) {
+
+      Areas areas = import(generator, BethYw::InputFiles::AQI);
+
+      THEN( "each measure is imported" ) {
+
+        REQUIRE( areas.getArea(DatasetGenerator::areaCode(0)).size() == 3 );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a WelshStatsJSON file with a single measure is generated and imported" ) {
+
+      Areas areas = import(generator, BethYw::InputFiles::TRAINS);
+
+      THEN( "there is one measure for each area" ) {
+
+        REQUIRE( areas.getImportStats().readingsAccepted == 5 * 4 );
+        REQUIRE( areas.getArea(DatasetGenerator::areaCode(3)).size() == 1 );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "an AuthorityByYearCSV file is generated and imported" ) {
+
+      Areas areas = import(generator, BethYw::InputFiles::COMPLETE_POP);
+
+      THEN( "there is a reading for each area and year" ) {
+
+        REQUIRE( areas.size() == 5 );
+        REQUIRE( areas.getArea(DatasetGenerator::areaCode(2)).getMeasure("pop").size() == 4 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "two generators with the same seed" ) {
+
+    DatasetGenerator first(3, 2, 10, 42);
+    DatasetGenerator second(3, 2, 10, 42);
+
+    THEN( "they generate the same file" ) {
+
+      std::ostringstream a;
+      std::ostringstream b;
+      first.write(a, BethYw::InputFiles::POPDEN);
+      second.write(b, BethYw::InputFiles::POPDEN);
+
+      REQUIRE( a.str() == b.str() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "numbers that are out of range" ) {
+
+    THEN( "a std::invalid_argument is thrown" ) {
+
+      REQUIRE_THROWS_AS( DatasetGenerator(0, 1, 1), std::invalid_argument );
+      REQUIRE_THROWS_AS( DatasetGenerator(1, 0, 1), std::invalid_argument );
+      REQUIRE_THROWS_AS( DatasetGenerator(1, 1, 1022), std::invalid_argument );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
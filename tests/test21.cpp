@@ -0,0 +1,113 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <locale>
+#include <string>
+#include <string_view>
+
+#include "../numbers.h"
+#include "../bethyw.h"
+
+SCENARIO( "values and years can be parsed from text", "[parseDouble][parseUnsigned]" ) {
+
+  GIVEN( "the text of a value" ) {
+
+    double value = -1;
+
+    THEN( "a plain decimal number is parsed" ) {
+
+      REQUIRE( BethYw::parseDouble("95.701706", value) );
+      REQUIRE( value == 95.701706 );
+
+    } // THEN
+
+    THEN( "negative numbers and exponents are parsed" ) {
+
+      REQUIRE( BethYw::parseDouble("-1.5e3", value) );
+      REQUIRE( value == -1500 );
+
+    } // THEN
+
+    THEN( "leading whitespace and a + are skipped, like std::stod" ) {
+
+      REQUIRE( BethYw::parseDouble("  +42", value) );
+      REQUIRE( value == 42 );
+
+    } // THEN
+
+    THEN( "parsing stops at the end of the number, like std::stod" ) {
+
+      REQUIRE( BethYw::parseDouble("12.5kg", value) );
+      REQUIRE( value == 12.5 );
+
+    } // THEN
+
+    THEN( "text that is not a number is rejected" ) {
+
+      REQUIRE_FALSE( BethYw::parseDouble("", value) );
+      REQUIRE_FALSE( BethYw::parseDouble("abc", value) );
+      REQUIRE_FALSE( BethYw::parseDouble(".", value) );
+      REQUIRE( value == -1 );
+
+    } // THEN
+
+    THEN( "the decimal point is '.' whatever the global locale" ) {
+
+      //a locale whose numbers are written with a decimal comma
+      struct DecimalComma : std::numpunct<char> {
+        char do_decimal_point() const override { return ','; }
+      };
+      std::locale previous = std::locale::global(std::locale(std::locale::classic(), new DecimalComma));
+      bool parsed = BethYw::parseDouble("12.5", value);
+      std::locale::global(previous);
+
+      REQUIRE( parsed );
+      REQUIRE( value == 12.5 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "the text of a year" ) {
+
+    unsigned int year = 0;
+
+    THEN( "a whole number is parsed" ) {
+
+      REQUIRE( BethYw::parseUnsigned("2015", year) );
+      REQUIRE( year == 2015 );
+
+    } // THEN
+
+    THEN( "text with anything other than digits is rejected" ) {
+
+      REQUIRE_FALSE( BethYw::parseUnsigned("", year) );
+      REQUIRE_FALSE( BethYw::parseUnsigned("20a5", year) );
+      REQUIRE_FALSE( BethYw::parseUnsigned(" 2015", year) );
+      REQUIRE_FALSE( BethYw::parseUnsigned("-2015", year) );
+      REQUIRE_FALSE( BethYw::parseUnsigned("99999999999", year) );
+
+    } // THEN
+
+    THEN( "validateYear accepts a string_view" ) {
+
+      std::string_view text = "2015-2018";
+      REQUIRE( BethYw::validateYear(text.substr(0, 4)) == 2015 );
+      REQUIRE( BethYw::validateYear(text.substr(5)) == 2018 );
+      REQUIRE_THROWS_AS( BethYw::validateYear(text), std::invalid_argument );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
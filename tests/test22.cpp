@@ -0,0 +1,126 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../symbols.h"
+#include "../area.h"
+
+SCENARIO( "codes can be interned as IDs in a SymbolTable", "[SymbolTable]" ) {
+
+  GIVEN( "a new SymbolTable" ) {
+
+    SymbolTable table;
+
+    THEN( "the empty string is ID 0" ) {
+
+      REQUIRE( table.size() == 1 );
+      REQUIRE( table.intern("") == 0 );
+      REQUIRE( table.name(0) == "" );
+
+    } // THEN
+
+    THEN( "interning the same string twice gives the same ID" ) {
+
+      SymbolID pop = table.intern("pop");
+      SymbolID dens = table.intern("dens");
+      REQUIRE( pop != dens );
+      REQUIRE( table.intern(std::string("pop")) == pop );
+      REQUIRE( table.name(pop) == "pop" );
+      REQUIRE( table.name(dens) == "dens" );
+      REQUIRE( table.size() == 3 );
+
+    } // THEN
+
+    THEN( "find() does not add strings to the table" ) {
+
+      SymbolID id = 99;
+      REQUIRE_FALSE( table.find("pop", id) );
+      REQUIRE( id == 99 );
+      REQUIRE( table.size() == 1 );
+
+      SymbolID pop = table.intern("pop");
+      REQUIRE( table.find("pop", id) );
+      REQUIRE( id == pop );
+
+    } // THEN
+
+    THEN( "asking for the name of an unknown ID throws a std::out_of_range" ) {
+
+      REQUIRE_THROWS_AS( table.name(42), std::out_of_range );
+
+    } // THEN
+
+    THEN( "sorted() orders entries by the strings of their IDs" ) {
+
+      std::map<SymbolID, int> entries;
+      entries[table.intern("W06000024")] = 3;
+      entries[table.intern("W06000011")] = 1;
+      entries[table.intern("W06000015")] = 2;
+
+      auto sorted = table.sorted(entries);
+      REQUIRE( sorted.size() == 3 );
+      REQUIRE( sorted[0]->second == 1 );
+      REQUIRE( sorted[1]->second == 2 );
+      REQUIRE( sorted[2]->second == 3 );
+
+    } // THEN
+
+    THEN( "strings interned on several threads at once each get one ID" ) {
+
+      std::vector<std::vector<SymbolID>> ids(4);
+      std::vector<std::thread> threads;
+      for (auto &threadIds : ids) {
+        threads.emplace_back([&table, &threadIds]() {
+          for (unsigned int i = 0; i < 1000; i++)
+            threadIds.push_back(table.intern("W" + std::to_string(i)));
+        });
+      }
+      for (auto &thread : threads)
+        thread.join();
+
+      REQUIRE( table.size() == 1001 );
+      for (auto const &threadIds : ids)
+        REQUIRE( threadIds == ids[0] );
+      REQUIRE( table.name(ids[0][500]) == "W500" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Area with a measure" ) {
+
+    Area area("W06000011");
+    area.setName("eng", "Swansea");
+    area.setMeasure("Pop", Measure("Pop", "Population"));
+
+    THEN( "the Area is keyed by the ID of its code in the shared table" ) {
+
+      REQUIRE( SymbolTable::areas().name(area.getLocalAuthorityID()) == "W06000011" );
+      REQUIRE( area.getLocalAuthorityCode() == "W06000011" );
+
+    } // THEN
+
+    THEN( "the measure can be found in any case" ) {
+
+      REQUIRE( area.getMeasure("pop").getCodename() == "Pop" );
+      REQUIRE( area.getMeasure("POP").getLabel() == "Population" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,209 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../columns.h"
+
+SCENARIO( "Areas imported into a ColumnStore match Areas imported as objects", "[Areas][ColumnStore]" ) {
+
+  const std::string dir = std::string("datasets") + DIR_SEP;
+  std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+
+  auto import = [&](AreasStorage storage,
+                    const std::vector<BethYw::InputFileSource> &datasets,
+                    const StringFilterSet &areasFilter,
+                    const StringFilterSet &measuresFilter,
+                    const YearFilterTuple &yearsFilter,
+                    unsigned int threads) {
+    Areas areas;
+    areas.setStorage(storage);
+    BethYw::loadAreas(areas, dir, areasFilter);
+    BethYw::loadDatasets(areas, dir, datasets, areasFilter, measuresFilter, yearsFilter, threads);
+    return areas;
+  };
+
+  GIVEN( "every dataset, with no filters" ) {
+
+    StringFilterSet none;
+    YearFilterTuple allYears = std::make_tuple(0, 0);
+
+    THEN( "the JSON is the same, imported one dataset after another" ) {
+
+      Areas objects = import(AreasStorage::Objects, datasets, none, none, allYears, 1);
+      Areas columns = import(AreasStorage::Columns, datasets, none, none, allYears, 1);
+      REQUIRE( columns.getColumns().size() > 0 );
+      REQUIRE( objects.getColumns().size() == 0 );
+      REQUIRE( columns.size() == objects.size() );
+      REQUIRE( columns.toJSON() == objects.toJSON() );
+
+    } // THEN
+
+    THEN( "the JSON is the same, imported on several threads" ) {
+
+      Areas objects = import(AreasStorage::Objects, datasets, none, none, allYears, 1);
+      Areas columns = import(AreasStorage::Columns, datasets, none, none, allYears, 4);
+      REQUIRE( columns.toJSON() == objects.toJSON() );
+
+    } // THEN
+
+    THEN( "a CSV dataset replaces the measure imported from a JSON dataset, as it does for objects" ) {
+
+      std::vector<BethYw::InputFileSource> overlapping = {BethYw::InputFiles::POPDEN,
+                                                          BethYw::InputFiles::COMPLETE_POP,
+                                                          BethYw::InputFiles::POPDEN};
+      Areas objects = import(AreasStorage::Objects, overlapping, none, none, allYears, 1);
+      Areas columns = import(AreasStorage::Columns, overlapping, none, none, allYears, 1);
+      REQUIRE( columns.toJSON() == objects.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every dataset, filtered to two areas, two measures and a range of years" ) {
+
+    StringFilterSet areasFilter({"W06000011", "W06000024"});
+    StringFilterSet measuresFilter({"pop", "dens"});
+    YearFilterTuple yearsFilter = std::make_tuple(2000, 2010);
+
+    THEN( "the JSON is the same" ) {
+
+      Areas objects = import(AreasStorage::Objects, datasets, areasFilter, measuresFilter, yearsFilter, 1);
+      Areas columns = import(AreasStorage::Columns, datasets, areasFilter, measuresFilter, yearsFilter, 1);
+      REQUIRE( columns.toJSON() == objects.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "popu1009.json imported into a ColumnStore" ) {
+
+    StringFilterSet none;
+    YearFilterTuple allYears = std::make_tuple(0, 0);
+    std::vector<BethYw::InputFileSource> popden = {BethYw::InputFiles::POPDEN};
+    Areas areas = import(AreasStorage::Columns, popden, none, none, allYears, 1);
+
+    THEN( "a scan of the columns finds the same readings as the Measure objects" ) {
+
+      const ColumnStore &columns = areas.getColumns();
+      SymbolID swansea = SymbolTable::areas().intern("W06000011");
+      SymbolID pop = SymbolTable::measures().intern("pop");
+      double total = 0;
+      unsigned int readings = 0;
+      for (std::size_t row = 0; row < columns.size(); row++) {
+        if (columns.areas()[row] == swansea &&
+            columns.getMeasure(columns.measures()[row]).key == pop &&
+            (columns.flags()[row] & ColumnStore::HAS_VALUE)) {
+          total += columns.values()[row];
+          readings++;
+        }
+      }
+
+      Measure &measure = areas.getArea("W06000011").getMeasure("pop");
+      REQUIRE( readings == measure.size() );
+      REQUIRE( total == Approx(measure.getAverage() * measure.size()) );
+      REQUIRE( measure.getValue(2015) == Approx(242316) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Areas built from a ColumnStore keep names set after they were built", "[Areas][ColumnStore]" ) {
+
+  const std::string areasCSV = "Local authority code,Name (eng),Name (cym)\nW06000011,Swansea,Abertawe\n";
+  const std::string popCSV = "AuthorityCode,2015\nW06000011,242316\n";
+
+  auto import = [&](AreasStorage storage, const std::string &renamedCSV) {
+    Areas areas;
+    areas.setStorage(storage);
+    areas.populate(std::string_view(areasCSV), BethYw::InputFiles::AREAS.PARSER, BethYw::InputFiles::AREAS.COLS);
+    REQUIRE( areas.size() == 1 );
+
+    Area renamed("W06000011");
+    renamed.setName("eng", "City and County of Swansea");
+    areas.setArea("W06000011", renamed);
+
+    areas.populate(std::string_view(popCSV), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                   BethYw::InputFiles::COMPLETE_POP.COLS);
+    if (!renamedCSV.empty())
+      areas.populate(std::string_view(renamedCSV), BethYw::InputFiles::AREAS.PARSER, BethYw::InputFiles::AREAS.COLS);
+    return areas;
+  };
+
+  GIVEN( "an Area renamed with setArea() before more rows are imported" ) {
+
+    THEN( "the new name is kept" ) {
+
+      for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+        Areas areas = import(storage, "");
+        REQUIRE( areas.getArea("W06000011").getName("eng") == "City and County of Swansea" );
+        REQUIRE( areas.getArea("W06000011").getName("cym") == "Abertawe" );
+      }
+      REQUIRE( import(AreasStorage::Columns, "").toJSON() == import(AreasStorage::Objects, "").toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an areas file imported again with other names" ) {
+
+    const std::string renamedCSV = "Local authority code,Name (eng),Name (cym)\nW06000011,Swansea City,Dinas Abertawe\n";
+
+    THEN( "its names replace the names of the Areas already built" ) {
+
+      for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+        Areas areas = import(storage, renamedCSV);
+        REQUIRE( areas.getArea("W06000011").getName("eng") == "Swansea City" );
+        REQUIRE( areas.getArea("W06000011").getName("cym") == "Dinas Abertawe" );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Areas with rows that have not been built yet" ) {
+
+    Areas areas;
+    areas.setStorage(AreasStorage::Columns);
+    areas.populate(std::string_view(areasCSV), BethYw::InputFiles::AREAS.PARSER, BethYw::InputFiles::AREAS.COLS);
+    areas.populate(std::string_view(popCSV), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                   BethYw::InputFiles::COMPLETE_POP.COLS);
+
+    THEN( "several threads can read them at once" ) {
+
+      const Areas &view = areas;
+      std::vector<std::string> json(4);
+      std::vector<std::thread> readers;
+      for (std::size_t i = 0; i < json.size(); i++)
+        readers.emplace_back([&view, &json, i]() { json[i] = view.toJSON(); });
+      for (auto &reader : readers)
+        reader.join();
+
+      for (auto const &output : json)
+        REQUIRE( output == json[0] );
+      REQUIRE( json[0].find("242316") != std::string::npos );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,108 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../memory.h"
+
+SCENARIO( "Areas can allocate its Area and Measure objects from a memory resource", "[Areas][memory]" ) {
+
+  const std::string dir = std::string("datasets") + DIR_SEP;
+  std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+  StringFilterSet none;
+  YearFilterTuple allYears = std::make_tuple(0, 0);
+
+  auto load = [&](Areas &areas, unsigned int threads) {
+    BethYw::loadAreas(areas, dir, none);
+    BethYw::loadDatasets(areas, dir, datasets, none, none, allYears, threads);
+  };
+
+  GIVEN( "every dataset imported on the heap and in an arena" ) {
+
+    CountingResource heap;
+    Areas onHeap(&heap);
+    load(onHeap, 1);
+
+    CountingResource blocks;
+    std::pmr::monotonic_buffer_resource arena(&blocks);
+    Areas inArena(&arena);
+    load(inArena, 1);
+
+    THEN( "the Areas are the same" ) {
+
+      REQUIRE( inArena.getResource() == &arena );
+      REQUIRE( inArena.toJSON() == onHeap.toJSON() );
+
+    } // THEN
+
+    THEN( "the arena makes far fewer allocations than the heap" ) {
+
+      REQUIRE( heap.allocations() > 1000 );
+      REQUIRE( blocks.allocations() > 0 );
+      REQUIRE( blocks.allocations() * 100 < heap.allocations() );
+
+    } // THEN
+
+    THEN( "an Area copied out of the arena does not use the arena" ) {
+
+      Area copy = inArena.getArea("W06000011");
+      REQUIRE( inArena.getArea("W06000011").get_allocator().resource() == &arena );
+      REQUIRE( copy.get_allocator().resource() == std::pmr::get_default_resource() );
+      REQUIRE( copy.getMeasure("pop").get_allocator().resource() == std::pmr::get_default_resource() );
+      REQUIRE( copy == inArena.getArea("W06000011") );
+
+    } // THEN
+
+    THEN( "an Area set from outside the arena is copied into it" ) {
+
+      Area area("W06099999");
+      area.setName("eng", "Nowhere");
+      Measure measure("Pop", "Population");
+      measure.setValue(2015, 1);
+      area.setMeasure("Pop", measure);
+      inArena.setArea("W06099999", area);
+
+      Area &stored = inArena.getArea("W06099999");
+      REQUIRE( stored.get_allocator().resource() == &arena );
+      REQUIRE( stored.getMeasure("pop").get_allocator().resource() == &arena );
+      REQUIRE( stored == area );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every dataset imported on several threads into an arena" ) {
+
+    std::pmr::monotonic_buffer_resource arena;
+    Areas inArena(&arena);
+    load(inArena, 4);
+
+    Areas onHeap;
+    load(onHeap, 1);
+
+    THEN( "the shards are copied into the arena, and the Areas are the same" ) {
+
+      REQUIRE( inArena.getArea("W06000011").getMeasure("pop").get_allocator().resource() == &arena );
+      REQUIRE( inArena.toJSON() == onHeap.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
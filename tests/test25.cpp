@@ -0,0 +1,240 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../memory.h"
+
+SCENARIO( "Area and Measure objects can be imported into in place", "[Areas][Area][Measure][ingest]" ) {
+
+  GIVEN( "an Area with a Measure for 1999 and 2000" ) {
+
+    Area area("W06000011");
+    Measure measure("Pop", "Population");
+    measure.setValue(1999, 1);
+    measure.setValue(2000, 2);
+    area.setMeasure("Pop", measure);
+
+    THEN( "measureFor() returns the same Measure, relabelled, to set values in" ) {
+
+      Measure &found = area.measureFor("pop", "Mid-year population");
+      found.setValue(2000, 20);
+      found.setValue(2001, 21);
+
+      REQUIRE( area.size() == 1 );
+      REQUIRE( &found == &area.getMeasure("pop") );
+      REQUIRE( found.getCodename() == "pop" );
+      REQUIRE( found.getLabel() == "Mid-year population" );
+      REQUIRE( found.getValue(1999) == 1 );
+      REQUIRE( found.getValue(2000) == 20 );
+      REQUIRE( found.getValue(2001) == 21 );
+
+    } // THEN
+
+    THEN( "measureFor() adds a Measure the Area does not have" ) {
+
+      area.measureFor("Dens", "Population density").setValue(1999, 3);
+
+      REQUIRE( area.size() == 2 );
+      REQUIRE( area.getMeasure("dens").getValue(1999) == 3 );
+
+    } // THEN
+
+    THEN( "replaceMeasure() returns an empty Measure in place of the old one" ) {
+
+      Measure &replaced = area.replaceMeasure("Pop", "Population");
+      replaced.setValue(2001, 21);
+
+      REQUIRE( area.getMeasure("pop").size() == 1 );
+      REQUIRE( area.getMeasure("pop").getValue(2001) == 21 );
+
+    } // THEN
+
+    THEN( "a Measure moved in with setMeasure() is combined as one copied in" ) {
+
+      Measure newer("Pop", "Population");
+      newer.setValue(2000, 20);
+      Area copied = area;
+      copied.setMeasure("Pop", newer);
+      area.setMeasure("Pop", std::move(newer));
+
+      REQUIRE( area == copied );
+      REQUIRE( area.getMeasure("pop").getValue(1999) == 1 );
+      REQUIRE( area.getMeasure("pop").getValue(2000) == 20 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Areas instance with an Area that has two names and a Measure" ) {
+
+    Areas areas;
+    Area &area = areas.emplaceArea("W06000011");
+    area.setName("eng", "Swansea");
+    area.setName("cym", "Abertawe");
+    area.measureFor("Pop", "Population").setValue(1999, 1);
+
+    THEN( "emplaceArea() returns the same Area" ) {
+
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( &areas.emplaceArea("W06000011") == &area );
+      REQUIRE( &areas.getArea("W06000011") == &area );
+
+    } // THEN
+
+    THEN( "an Area moved in with setArea() replaces its names and Measures, and keeps the rest" ) {
+
+      Area newer("W06000011");
+      newer.setName("eng", "City of Swansea");
+      newer.measureFor("Dens", "Population density").setValue(1999, 3);
+      areas.setArea("W06000011", std::move(newer));
+
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( area.getName("eng") == "City of Swansea" );
+      REQUIRE( area.getName("cym") == "Abertawe" );
+      REQUIRE( area.size() == 2 );
+      REQUIRE( area.getMeasure("pop").getValue(1999) == 1 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every dataset imported into an arena" ) {
+
+    const std::string dir = std::string("datasets") + DIR_SEP;
+    std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                  BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+    StringFilterSet none;
+    YearFilterTuple allYears = std::make_tuple(0, 0);
+
+    std::pmr::monotonic_buffer_resource arena;
+    Areas areas(&arena);
+
+    //anything allocated outside the arena is a temporary Area or Measure
+    CountingResource elsewhere;
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(&elsewhere);
+    BethYw::loadAreas(areas, dir, none);
+    BethYw::loadDatasets(areas, dir, datasets, none, none, allYears, 1);
+    std::pmr::set_default_resource(previous);
+
+    THEN( "no Area or Measure is built outside the Areas and copied in" ) {
+
+      REQUIRE( areas.size() > 0 );
+      REQUIRE( elsewhere.allocations() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every dataset imported on several threads with a counted upstream" ) {
+
+    const std::string dir = std::string("datasets") + DIR_SEP;
+    std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                  BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+    StringFilterSet none;
+    YearFilterTuple allYears = std::make_tuple(0, 0);
+
+    CountingResource heap;
+    std::pmr::memory_resource *before = std::pmr::get_default_resource();
+    std::pmr::monotonic_buffer_resource arena(&heap);
+    Areas areas(&arena);
+    BethYw::loadAreas(areas, dir, none);
+    BethYw::loadDatasets(areas, dir, datasets, none, none, allYears, 4, nullptr, &heap);
+
+    THEN( "the arenas of the shards take their blocks from it and the default resource is left alone" ) {
+
+      REQUIRE( areas.size() > 0 );
+      REQUIRE( heap.allocations() > 0 );
+      REQUIRE( std::pmr::get_default_resource() == before );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a Measure moved from is left with no readings", "[Measure][pmr]" ) {
+
+  auto reading = [](Measure &measure) {
+    measure.setValue(1999, 1);
+    measure.setValue(2001, 4);
+  };
+
+  auto requireEmpty = [](Measure &measure) {
+    REQUIRE( measure.size() == 0 );
+    REQUIRE( measure.getDifference() == 0 );
+    REQUIRE( measure.getAverage() == 0 );
+    REQUIRE_THROWS_AS( measure.getValue(1999), std::out_of_range );
+    measure.setValue(2010, 2);
+    REQUIRE( measure.size() == 1 );
+    REQUIRE( measure.getValue(2010) == 2 );
+  };
+
+  std::pmr::monotonic_buffer_resource arena;
+
+  GIVEN( "a Measure moved into another memory resource" ) {
+
+    Measure measure("Pop", "Population");
+    reading(measure);
+    Measure moved(std::move(measure), Measure::allocator_type(&arena));
+
+    THEN( "the new Measure has the readings and the old one has none" ) {
+
+      REQUIRE( moved.size() == 2 );
+      REQUIRE( moved.getDifference() == 3 );
+      requireEmpty(measure);
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a Measure moved within its memory resource" ) {
+
+    Measure measure("Pop", "Population");
+    reading(measure);
+    Measure moved(std::move(measure));
+
+    THEN( "the new Measure has the readings and the old one has none" ) {
+
+      REQUIRE( moved.size() == 2 );
+      requireEmpty(measure);
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a Measure move assigned to one in another memory resource" ) {
+
+    Measure measure("Pop", "Population");
+    reading(measure);
+    Measure assigned{Measure::allocator_type(&arena)};
+    assigned = std::move(measure);
+
+    THEN( "the assigned Measure has the readings and the old one has none" ) {
+
+      REQUIRE( assigned.size() == 2 );
+      REQUIRE( assigned.getValue(2001) == 4 );
+      requireEmpty(measure);
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
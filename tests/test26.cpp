@@ -0,0 +1,122 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../columns.h"
+#include "../generator.h"
+
+SCENARIO( "a batch of rows can be committed into Areas at once", "[Areas][ColumnStore][commit]" ) {
+
+  const SymbolID swansea = SymbolTable::areas().intern("W06000011");
+  const SymbolID eng = SymbolTable::languages().intern("eng");
+
+  auto batch = [&]() {
+    ColumnStore rows;
+    rows.setName(swansea, eng, "City of Swansea");
+    std::uint32_t pop = rows.measure("Pop", "Population");
+    rows.addRow(swansea, pop, 2014, 240000, ColumnStore::HAS_VALUE | ColumnStore::REPLACE);
+    rows.addRow(swansea, pop, 2015, 242316, ColumnStore::HAS_VALUE);
+    return rows;
+  };
+
+  GIVEN( "an Areas instance with Objects storage that already has the area" ) {
+
+    Areas areas;
+    Area &area = areas.emplaceArea("W06000011");
+    area.setName("eng", "Swansea");
+    area.measureFor("Pop", "Population").setValue(2000, 1);
+
+    THEN( "a batch that replaces names and measures does so" ) {
+
+      areas.commit(batch(), true);
+
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( area.getName("eng") == "City of Swansea" );
+      REQUIRE( area.getMeasure("pop").size() == 2 );
+      REQUIRE( area.getMeasure("pop").getValue(2015) == 242316 );
+
+    } // THEN
+
+    THEN( "a batch that keeps names leaves the area's name alone" ) {
+
+      areas.commit(batch(), false);
+
+      REQUIRE( area.getName("eng") == "Swansea" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "the same batch committed with Objects and Columns storage" ) {
+
+    Areas objects;
+    objects.commit(batch(), true);
+
+    Areas columns;
+    columns.setStorage(AreasStorage::Columns);
+    columns.commit(batch(), true);
+
+    THEN( "the Areas are the same, and the rows are kept with Columns storage" ) {
+
+      REQUIRE( objects.getColumns().size() == 0 );
+      REQUIRE( columns.getColumns().size() == 2 );
+      REQUIRE( columns.toJSON() == objects.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an AuthorityByYearCSV file with 60 year columns" ) {
+
+    DatasetGenerator generator(20, 1, 60);
+    std::ostringstream file;
+    generator.write(file, BethYw::InputFiles::COMPLETE_POP);
+    const std::string contents = file.str();
+
+    auto import = [&](AreasStorage storage) {
+      Areas areas;
+      areas.setStorage(storage);
+      areas.populate(std::string_view(contents), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                     BethYw::InputFiles::COMPLETE_POP.COLS);
+      return areas;
+    };
+
+    THEN( "each area has one Measure with a reading for every year" ) {
+
+      Areas areas = import(AreasStorage::Objects);
+      REQUIRE( areas.size() == 20 );
+      REQUIRE( areas.getArea(DatasetGenerator::areaCode(19)).size() == 1 );
+      REQUIRE( areas.getArea(DatasetGenerator::areaCode(19)).getMeasure("pop").size() == 60 );
+      REQUIRE( areas.toJSON() == import(AreasStorage::Columns).toJSON() );
+
+    } // THEN
+
+    THEN( "importing it again replaces each Measure rather than adding to it" ) {
+
+      Areas areas = import(AreasStorage::Objects);
+      Measure &measure = areas.getArea(DatasetGenerator::areaCode(0)).getMeasure("pop");
+      measure.setValue(1900, 1);
+      areas.populate(std::string_view(contents), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                     BethYw::InputFiles::COMPLETE_POP.COLS);
+      REQUIRE( areas.getArea(DatasetGenerator::areaCode(0)).getMeasure("pop").size() == 60 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
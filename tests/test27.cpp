@@ -0,0 +1,140 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../symbolmap.h"
+#include "../area.h"
+#include "../memory.h"
+
+SCENARIO( "a SymbolMap maps IDs to values with open addressing", "[SymbolMap]" ) {
+
+  GIVEN( "a SymbolMap with 1000 entries, added in descending order" ) {
+
+    SymbolMap<std::string> map;
+    for (SymbolID id = 1000; id > 0; id--)
+      REQUIRE( map.try_emplace(id, std::to_string(id)).second );
+
+    THEN( "every entry can be found, and other IDs cannot" ) {
+
+      REQUIRE( map.size() == 1000 );
+      for (SymbolID id = 1; id <= 1000; id++)
+        REQUIRE( map.find(id)->second == std::to_string(id) );
+      REQUIRE( map.find(0) == map.end() );
+      REQUIRE( map.find(1001) == map.end() );
+      REQUIRE( map.count(500) == 1 );
+      REQUIRE( map.count(5000) == 0 );
+      REQUIRE_THROWS_AS( map.at(5000), std::out_of_range );
+
+    } // THEN
+
+    THEN( "adding an ID that is already there keeps the existing value" ) {
+
+      auto added = map.try_emplace(7, "seven");
+      REQUIRE_FALSE( added.second );
+      REQUIRE( added.first->second == "7" );
+      REQUIRE( map.size() == 1000 );
+
+    } // THEN
+
+    THEN( "the entries are iterated in the order they were added" ) {
+
+      SymbolID expected = 1000;
+      for (auto const &entry : map)
+        REQUIRE( entry.first == expected-- );
+
+    } // THEN
+
+    THEN( "references to entries stay valid as more are added" ) {
+
+      std::string *first = &map.at(1000);
+      for (SymbolID id = 1001; id <= 5000; id++)
+        map[id] = std::to_string(id);
+      REQUIRE( &map.at(1000) == first );
+      REQUIRE( map.size() == 5000 );
+      REQUIRE( map.at(5000) == "5000" );
+
+    } // THEN
+
+    THEN( "clear() removes every entry" ) {
+
+      map.clear();
+      REQUIRE( map.size() == 0 );
+      REQUIRE( map.find(1) == map.end() );
+      map[1] = "one";
+      REQUIRE( map.at(1) == "one" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a SymbolMap with as many entries as its table holds before it grows" ) {
+
+    CountingResource heap;
+    SymbolMap<std::string> map(&heap);
+    for (SymbolID id = 1; id <= 8; id++)
+      map[id] = std::to_string(id);
+
+    THEN( "looking up an ID that is already there does not grow the table" ) {
+
+      const auto allocations = heap.allocations();
+      REQUIRE_FALSE( map.try_emplace(3, "three").second );
+      REQUIRE( map[5] == "5" );
+      REQUIRE( heap.allocations() == allocations );
+
+    } // THEN
+
+    THEN( "adding a new ID grows it and keeps every entry" ) {
+
+      const auto allocations = heap.allocations();
+      REQUIRE( map.try_emplace(9, "9").second );
+      REQUIRE( heap.allocations() > allocations );
+      for (SymbolID id = 1; id <= 9; id++)
+        REQUIRE( map.at(id) == std::to_string(id) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a SymbolMap of Areas in an arena" ) {
+
+    std::pmr::monotonic_buffer_resource arena;
+    SymbolMap<Area> areas(&arena);
+    Area &area = areas.try_emplace(SymbolTable::areas().intern("W06000011"), "W06000011").first->second;
+    area.setName("eng", "Swansea");
+
+    THEN( "the Areas are allocated from the arena" ) {
+
+      REQUIRE( area.get_allocator().resource() == &arena );
+
+    } // THEN
+
+    THEN( "moving it into a SymbolMap on the heap copies the Areas out of the arena" ) {
+
+      SymbolMap<Area> heap;
+      heap = std::move(areas);
+      REQUIRE( areas.size() == 0 );
+      REQUIRE( heap.size() == 1 );
+      Area &moved = heap.at(SymbolTable::areas().intern("W06000011"));
+      REQUIRE( moved.getName("eng") == "Swansea" );
+      REQUIRE( moved.get_allocator().resource() == std::pmr::get_default_resource() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
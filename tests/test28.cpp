@@ -0,0 +1,174 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../symbols.h"
+#include "../areas.h"
+
+SCENARIO( "area codes are decoded for the dense index", "[SymbolTable][dense]" ) {
+
+  std::size_t type = 0, number = 0;
+
+  THEN( "codes in the pattern are decoded into a type and a number" ) {
+
+    REQUIRE( SymbolTable::decodeAreaCode("W06000024", type, number) );
+    REQUIRE( type == 2206 );
+    REQUIRE( number == 24 );
+
+    REQUIRE( SymbolTable::decodeAreaCode("A00000000", type, number) );
+    REQUIRE( type == 0 );
+    REQUIRE( number == 0 );
+
+    REQUIRE( SymbolTable::decodeAreaCode("E01035000", type, number) );
+    REQUIRE( type == 401 );
+    REQUIRE( number == 35000 );
+
+  } // THEN
+
+  THEN( "other codes and numbers too large for the index are not decoded" ) {
+
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("w06000024", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("W0600002", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("W060000240", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("W06A00024", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("W92", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("", type, number) );
+    REQUIRE_FALSE( SymbolTable::decodeAreaCode("W06999999", type, number) );
+
+  } // THEN
+
+} // SCENARIO
+
+SCENARIO( "a SymbolTable with a dense index gives the same IDs as one without", "[SymbolTable][dense]" ) {
+
+  GIVEN( "a table with a dense index and one without" ) {
+
+    SymbolTable dense(true);
+    SymbolTable plain;
+
+    const std::vector<std::string> codes = {
+      "W06000024", "W92000004", "E01000001", "wales", "W06999999",
+      "E01035000", "W06000024", "w06000024", "K04000001", "E01000001"
+    };
+
+    WHEN( "the same codes are interned in both" ) {
+
+      for (auto const &code : codes)
+        REQUIRE( dense.intern(code) == plain.intern(code) );
+
+      THEN( "every code can be found by its ID and its ID by its code" ) {
+
+        REQUIRE( dense.size() == plain.size() );
+        for (auto const &code : codes) {
+          SymbolID id = 0;
+          REQUIRE( dense.find(code, id) );
+          REQUIRE( id == plain.intern(code) );
+          REQUIRE( dense.name(id) == code );
+        }
+
+      } // THEN
+
+      THEN( "codes that were not interned are not found" ) {
+
+        SymbolID id = 0;
+        REQUIRE_FALSE( dense.find("W06000025", id) );
+        REQUIRE_FALSE( dense.find("E01999999", id) );
+        REQUIRE_FALSE( dense.find("Z99000000", id) );
+        REQUIRE_FALSE( dense.find("w06000025", id) );
+        REQUIRE( dense.find("", id) );
+        REQUIRE( id == 0 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "a table with a dense index shared by four threads" ) {
+
+    SymbolTable dense(true);
+    std::vector<std::vector<SymbolID>> ids(4);
+
+    WHEN( "each thread interns the same 20000 LSOA codes" ) {
+
+      std::vector<std::thread> threads;
+      for (auto &threadIDs : ids) {
+        threads.emplace_back([&dense, &threadIDs]() {
+          char code[16];
+          for (unsigned int lsoa = 1; lsoa <= 20000; lsoa++) {
+            std::snprintf(code, sizeof(code), "E01%06u", lsoa);
+            threadIDs.push_back(dense.intern(code));
+          }
+        });
+      }
+      for (auto &thread : threads)
+        thread.join();
+
+      THEN( "every thread was given the same ID for each code" ) {
+
+        REQUIRE( dense.size() == 20001 );
+        for (auto const &threadIDs : ids)
+          REQUIRE( threadIDs == ids[0] );
+        REQUIRE( dense.name(ids[0][41]) == "E01000042" );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Areas::getArea finds areas through the dense index", "[Areas][dense]" ) {
+
+  GIVEN( "an Areas instance with 30000 LSOA areas and one other code" ) {
+
+    Areas areas;
+    char code[16];
+    for (unsigned int lsoa = 1; lsoa <= 30000; lsoa++) {
+      std::snprintf(code, sizeof(code), "E01%06u", lsoa);
+      Area area(code);
+      area.setName("eng", "LSOA " + std::to_string(lsoa));
+      areas.setArea(code, std::move(area));
+    }
+    Area other("custom-area");
+    other.setName("eng", "Custom");
+    areas.setArea("custom-area", std::move(other));
+
+    THEN( "every area can be found by its code" ) {
+
+      REQUIRE( areas.size() == 30001 );
+      for (unsigned int lsoa = 1; lsoa <= 30000; lsoa++) {
+        std::snprintf(code, sizeof(code), "E01%06u", lsoa);
+        REQUIRE( areas.getArea(code).getName("eng") == "LSOA " + std::to_string(lsoa) );
+      }
+      REQUIRE( areas.getArea("custom-area").getName("eng") == "Custom" );
+
+    } // THEN
+
+    THEN( "codes with no area are not found" ) {
+
+      REQUIRE_THROWS_AS( areas.getArea("E01030001"), std::out_of_range );
+      REQUIRE_THROWS_AS( areas.getArea("e01000001"), std::out_of_range );
+      REQUIRE_THROWS_AS( areas.getArea("E01"), std::out_of_range );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,261 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../odata.h"
+#include "../lib_json.hpp"
+
+SCENARIO( "an ODataScanner reads the records of a StatsWales OData document", "[ODataScanner]" ) {
+
+  GIVEN( "a document with two records and another member" ) {
+
+    const std::string json =
+      "\xEF\xBB\xBF{\"odata.metadata\":\"http://example\",\"value\":[\n"
+      "  {\"Data\":95.701706,\"Code\":\"W06000001\",\"Count\":-3,\"Big\":18446744073709551616,\"Flag\":true},\n"
+      "  {\"Data\":\"1.5\",\"Code\":\"Ynys M\xC3\xB4n\",\"Empty\":null}\n"
+      "], \"odata.nextLink\": false}  \n";
+
+    ODataScanner scanner(json, true);
+    std::string_view key;
+    nlohmann::json value;
+
+    THEN( "the keys of each record are read in order and values read as nlohmann::json reads them" ) {
+
+      REQUIRE( scanner.nextRecord() );
+
+      REQUIRE( scanner.nextKey(key) );
+      REQUIRE( key == "Data" );
+      scanner.readValue(value);
+      REQUIRE( value.is_number_float() );
+      REQUIRE( value.get<double>() == 95.701706 );
+
+      REQUIRE( scanner.nextKey(key) );
+      REQUIRE( key == "Code" );
+      scanner.readValue(value);
+      REQUIRE( value == "W06000001" );
+
+      REQUIRE( scanner.nextKey(key) );
+      scanner.readValue(value);
+      REQUIRE( value.is_number_integer() );
+      REQUIRE( value.get<int>() == -3 );
+
+      REQUIRE( scanner.nextKey(key) );
+      scanner.readValue(value);
+      REQUIRE( value.is_number_float() );
+      REQUIRE( value == nlohmann::json::parse("18446744073709551616") );
+
+      REQUIRE( scanner.nextKey(key) );
+      scanner.readValue(value);
+      REQUIRE( value == true );
+
+      REQUIRE_FALSE( scanner.nextKey(key) );
+
+      REQUIRE( scanner.nextRecord() );
+      REQUIRE( scanner.nextKey(key) );
+      scanner.readValue(value);
+      REQUIRE( value == "1.5" );
+      REQUIRE( scanner.nextKey(key) );
+      scanner.readValue(value);
+      REQUIRE( value == "Ynys M\xC3\xB4n" );
+      REQUIRE( scanner.nextKey(key) );
+      REQUIRE( key == "Empty" );
+      scanner.skipValue();
+      REQUIRE_FALSE( scanner.nextKey(key) );
+
+      REQUIRE_FALSE( scanner.nextRecord() );
+      REQUIRE_FALSE( scanner.nextRecord() );
+
+    } // THEN
+
+    THEN( "records that are not read to the end are skipped" ) {
+
+      REQUIRE( scanner.nextRecord() );
+      REQUIRE( scanner.nextKey(key) );
+      REQUIRE( scanner.nextRecord() );
+      REQUIRE( scanner.nextKey(key) );
+      REQUIRE( key == "Data" );
+      REQUIRE_FALSE( scanner.nextRecord() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "documents the scanner does not handle" ) {
+
+    const std::vector<std::string> documents = {
+      "[]",
+      "{\"value\":[{\"Code\":\"W06\\u0030\"}]}",
+      "{\"value\":[{\"Code\":{\"nested\":1}}]}",
+      "{\"value\":[1]}",
+      "{\"value\":[{\"Code\":01}]}",
+      "{\"value\":[{\"Code\":\"W06\xC3\"}]}",
+      "{\"value\":[{\"Code\":\"W06\"}]",
+      "{\"value\":[{\"Code\":\"W06\"}]} x"
+    };
+
+    THEN( "each throws ODataScanner::Unexpected" ) {
+
+      for (auto const &json : documents) {
+        INFO( json );
+        auto scanAll = [&]() {
+          ODataScanner scanner(json, true);
+          std::string_view key;
+          nlohmann::json value;
+          while (scanner.nextRecord())
+            while (scanner.nextKey(key))
+              scanner.readValue(value);
+        };
+        REQUIRE_THROWS_AS( scanAll(), ODataScanner::Unexpected );
+      }
+
+    } // THEN
+
+    THEN( "content after the document is ignored when not strict" ) {
+
+      ODataScanner scanner("{\"value\":[]} x", false);
+      REQUIRE_FALSE( scanner.nextRecord() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "WelshStatsJSON files read with the scanner match the SAX parser", "[Areas][ODataScanner]" ) {
+
+  struct Result {
+    std::string json;
+    std::string error;
+    ImportStats stats;
+  };
+
+  auto import = [](WelshStatsJSONMode mode,
+                   const std::string &contents,
+                   const BethYw::InputFileSource &source,
+                   bool fromStream,
+                   const StringFilterSet *areasFilter,
+                   const StringFilterSet *measuresFilter,
+                   const YearFilterTuple *yearsFilter) {
+    Areas areas;
+    areas.setJSONMode(mode);
+    Result result;
+    try {
+      if (fromStream) {
+        std::istringstream is(contents);
+        areas.populate(is, source.PARSER, source.COLS, areasFilter, measuresFilter, yearsFilter);
+      } else {
+        areas.populate(std::string_view(contents), source.PARSER, source.COLS,
+                       areasFilter, measuresFilter, yearsFilter);
+      }
+    } catch (const std::exception &ex) {
+      result.error = ex.what();
+    }
+    try {
+      result.json = areas.toJSON();
+    } catch (const std::exception &ex) {
+      result.json = ex.what();
+    }
+    result.stats = areas.getImportStats();
+    return result;
+  };
+
+  auto requireSame = [](const Result &scanned, const Result &streamed) {
+    REQUIRE( scanned.error == streamed.error );
+    REQUIRE( scanned.json == streamed.json );
+    REQUIRE( scanned.stats.rows == streamed.stats.rows );
+    REQUIRE( scanned.stats.areasAccepted == streamed.stats.areasAccepted );
+    REQUIRE( scanned.stats.measuresAccepted == streamed.stats.measuresAccepted );
+    REQUIRE( scanned.stats.readingsAccepted == streamed.stats.readingsAccepted );
+  };
+
+  const std::vector<BethYw::InputFileSource> sources = {BethYw::InputFiles::POPDEN,
+                                                        BethYw::InputFiles::BIZ,
+                                                        BethYw::InputFiles::AQI,
+                                                        BethYw::InputFiles::TRAINS};
+
+  GIVEN( "the bundled WelshStatsJSON datasets" ) {
+
+    StringFilterSet areasFilter({"W06000011", "W06000024", "W92000004"});
+    StringFilterSet measuresFilter({"pop", "dens", "no2"});
+    YearFilterTuple yearsFilter = std::make_tuple(2010, 2015);
+
+    THEN( "the data and import counts are the same with and without filters" ) {
+
+      for (auto const &source : sources) {
+        INFO( source.FILE );
+        std::ifstream file(std::string("datasets") + DIR_SEP + source.FILE);
+        const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        REQUIRE( contents.size() > 0 );
+
+        for (bool fromStream : {false, true}) {
+          Result scanned = import(WelshStatsJSONMode::Scanner, contents, source, fromStream, nullptr, nullptr, nullptr);
+          REQUIRE( scanned.error.empty() );
+          requireSame(scanned, import(WelshStatsJSONMode::Streaming, contents, source, fromStream, nullptr, nullptr, nullptr));
+
+          requireSame(import(WelshStatsJSONMode::Scanner, contents, source, fromStream, &areasFilter, &measuresFilter, &yearsFilter),
+                      import(WelshStatsJSONMode::Streaming, contents, source, fromStream, &areasFilter, &measuresFilter, &yearsFilter));
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "files the scanner falls back to the SAX parser for" ) {
+
+    const std::string first =
+      "{\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Swansea\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2015\",\"Data\":242316}";
+    const std::vector<std::string> files = {
+      "{\"value\":[" + first + ",{\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Abertawe \\\"Swansea\\\"\","
+        "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2016\",\"Data\":\"244462\"}]}",
+      "{\"value\":[" + first + ",{\"Localauthority_Code\":\"W06000024\",\"Extra\":[1,2],"
+        "\"Localauthority_ItemName_ENG\":\"Merthyr Tydfil\",\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\","
+        "\"Year_Code\":\"2015\",\"Data\":60183}]}",
+      "{\"value\":[" + first + ",{\"Localauthority_Code\":\"W06000024\"}]}",
+      "{\"value\":[" + first + ",42]}",
+      "{\"value\":[" + first + "," + first + "}",
+      "{\"value\":[" + first + "]} trailing"
+    };
+
+    THEN( "the data, import counts and errors are the same as the SAX parser's" ) {
+
+      for (auto const &file : files) {
+        INFO( file );
+        requireSame(import(WelshStatsJSONMode::Scanner, file, BethYw::InputFiles::POPDEN, false, nullptr, nullptr, nullptr),
+                    import(WelshStatsJSONMode::Streaming, file, BethYw::InputFiles::POPDEN, false, nullptr, nullptr, nullptr));
+      }
+
+    } // THEN
+
+    THEN( "a file read from a stream ignores anything after the document" ) {
+
+      const std::string &file = files.back();
+      Result scanned = import(WelshStatsJSONMode::Scanner, file, BethYw::InputFiles::POPDEN, true, nullptr, nullptr, nullptr);
+      REQUIRE( scanned.error.empty() );
+      requireSame(scanned, import(WelshStatsJSONMode::Streaming, file, BethYw::InputFiles::POPDEN, true, nullptr, nullptr, nullptr));
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,222 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../generator.h"
+#include "../odata.h"
+#include "../lib_json.hpp"
+
+SCENARIO( "the records of a WelshStatsJSON file can be split into ranges", "[ODataScanner][threads]" ) {
+
+  GIVEN( "a generated file of 2000 records" ) {
+
+    DatasetGenerator generator(100, 2, 10);
+    std::ostringstream os;
+    generator.write(os, BethYw::InputFiles::POPDEN);
+    const std::string json = os.str();
+
+    WHEN( "it is split into 4 ranges" ) {
+
+      auto splits = ODataScanner::splitRecords(json, 4);
+
+      THEN( "each split is the start of a record after the last" ) {
+
+        REQUIRE( splits.size() == 3 );
+        for (std::size_t i = 0; i < splits.size(); i++) {
+          REQUIRE( json[splits[i]] == '{' );
+          REQUIRE( json.rfind('}', splits[i]) > json.rfind('"', splits[i]) );
+          if (i > 0)
+            REQUIRE( splits[i] > splits[i - 1] );
+        }
+
+      } // THEN
+
+      THEN( "reading the ranges reads every record once and in order" ) {
+
+        std::vector<std::size_t> bounds = {0};
+        bounds.insert(bounds.end(), splits.begin(), splits.end());
+        bounds.push_back(std::string_view::npos);
+
+        std::vector<std::string> rowKeys;
+        for (std::size_t i = 0; i + 1 < bounds.size(); i++) {
+          ODataScanner scanner(json, true);
+          scanner.setRange(bounds[i], bounds[i + 1]);
+          std::string_view key;
+          nlohmann::json value;
+          while (scanner.nextRecord()) {
+            while (scanner.nextKey(key)) {
+              if (key == "RowKey") {
+                scanner.readValue(value);
+                rowKeys.push_back(value.get<std::string>());
+              } else {
+                scanner.skipValue();
+              }
+            }
+          }
+        }
+
+        REQUIRE( rowKeys.size() == 2000 );
+        for (std::size_t row = 0; row < rowKeys.size(); row++)
+          REQUIRE( std::stoul(rowKeys[row]) == row );
+
+      } // THEN
+
+    } // WHEN
+
+    THEN( "a range that does not end at a record throws ODataScanner::Unexpected" ) {
+
+      auto splits = ODataScanner::splitRecords(json, 2);
+      REQUIRE( splits.size() == 1 );
+
+      ODataScanner scanner(json, true);
+      scanner.setRange(0, splits[0] + 1);
+      auto scanAll = [&]() {
+        std::string_view key;
+        while (scanner.nextRecord())
+          while (scanner.nextKey(key))
+            scanner.skipValue();
+      };
+      REQUIRE_THROWS_AS( scanAll(), ODataScanner::Unexpected );
+
+    } // THEN
+
+    THEN( "a file is not split into more parts than it has records" ) {
+
+      REQUIRE( ODataScanner::splitRecords("{\"value\":[{\"a\":1},{\"a\":2}]}", 8).size() == 1 );
+      REQUIRE( ODataScanner::splitRecords("{\"value\":[]}", 8).empty() );
+      REQUIRE( ODataScanner::splitRecords(json, 1).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a large WelshStatsJSON file imported on several threads matches one thread", "[Areas][ODataScanner][threads]" ) {
+
+  struct Result {
+    std::string json;
+    std::string error;
+    ImportStats stats;
+  };
+
+  DatasetGenerator generator(200, 5, 20);
+  std::ostringstream areasCSV;
+  generator.write(areasCSV, BethYw::InputFiles::AREAS);
+  std::ostringstream popden;
+  generator.write(popden, BethYw::InputFiles::POPDEN);
+
+  auto import = [&](unsigned int threads,
+                    AreasStorage storage,
+                    const std::string &contents,
+                    const StringFilterSet *areasFilter,
+                    const StringFilterSet *measuresFilter,
+                    const YearFilterTuple *yearsFilter) {
+    Areas areas;
+    areas.setStorage(storage);
+    areas.setJSONMode(WelshStatsJSONMode::Scanner);
+    areas.setThreads(threads);
+    Result result;
+    try {
+      areas.populate(std::string_view(areasCSV.str()), BethYw::InputFiles::AREAS.PARSER, BethYw::InputFiles::AREAS.COLS);
+      areas.populate(std::string_view(contents), BethYw::InputFiles::POPDEN.PARSER, BethYw::InputFiles::POPDEN.COLS,
+                     areasFilter, measuresFilter, yearsFilter);
+    } catch (const std::exception &ex) {
+      result.error = ex.what();
+    }
+    try {
+      result.json = areas.toJSON();
+    } catch (const std::exception &ex) {
+      result.json = ex.what();
+    }
+    result.stats = areas.getImportStats();
+    return result;
+  };
+
+  auto requireSame = [](const Result &parallel, const Result &sequential) {
+    REQUIRE( parallel.error == sequential.error );
+    REQUIRE( parallel.json == sequential.json );
+    REQUIRE( parallel.stats.rows == sequential.stats.rows );
+    REQUIRE( parallel.stats.areasAccepted == sequential.stats.areasAccepted );
+    REQUIRE( parallel.stats.measuresAccepted == sequential.stats.measuresAccepted );
+    REQUIRE( parallel.stats.readingsAccepted == sequential.stats.readingsAccepted );
+  };
+
+  GIVEN( "a generated file of 20000 records" ) {
+
+    const std::string json = popden.str();
+    REQUIRE( json.size() > 2 * 1024 * 1024 );
+
+    THEN( "the data and import counts are the same for both storages" ) {
+
+      for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+        Result parallel = import(4, storage, json, nullptr, nullptr, nullptr);
+        REQUIRE( parallel.error.empty() );
+        REQUIRE( parallel.stats.rows == 20200 );
+        requireSame(parallel, import(1, storage, json, nullptr, nullptr, nullptr));
+      }
+
+    } // THEN
+
+    THEN( "the data and import counts are the same with filters" ) {
+
+      StringFilterSet areasFilter({DatasetGenerator::areaCode(0), DatasetGenerator::areaCode(199)});
+      StringFilterSet measuresFilter({"m1", "m5"});
+      YearFilterTuple yearsFilter = std::make_tuple(2005, 2010);
+      requireSame(import(4, AreasStorage::Objects, json, &areasFilter, &measuresFilter, &yearsFilter),
+                  import(1, AreasStorage::Objects, json, &areasFilter, &measuresFilter, &yearsFilter));
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a generated file with records that look like splits inside its strings" ) {
+
+    std::string json = popden.str();
+    const std::string empty = "\"PartitionKey\":\"\"";
+    for (std::size_t at = json.find(empty); at != std::string::npos; at = json.find(empty, at + 1))
+      json.replace(at, empty.size(), "\"PartitionKey\":\"}, {\"");
+
+    THEN( "the data is the same as on one thread" ) {
+
+      requireSame(import(4, AreasStorage::Objects, json, nullptr, nullptr, nullptr),
+                  import(1, AreasStorage::Objects, json, nullptr, nullptr, nullptr));
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a generated file with an invalid year near its end" ) {
+
+    std::string json = popden.str();
+    const std::size_t at = json.rfind("\"2015\"");
+    json.replace(at, 6, "\"20x5\"");
+
+    THEN( "the error and the data imported before it are the same as on one thread" ) {
+
+      Result parallel = import(4, AreasStorage::Objects, json, nullptr, nullptr, nullptr);
+      REQUIRE_FALSE( parallel.error.empty() );
+      requireSame(parallel, import(1, AreasStorage::Objects, json, nullptr, nullptr, nullptr));
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,254 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../csv.h"
+#include "../generator.h"
+
+SCENARIO( "the rows of a CSV file can be split into ranges", "[CSVTokenizer][threads]" ) {
+
+  GIVEN( "a generated areas file of 1000 rows" ) {
+
+    DatasetGenerator generator(1000, 1, 1);
+    std::ostringstream os;
+    generator.write(os, BethYw::InputFiles::AREAS);
+    const std::string csv = os.str();
+    const std::size_t from = csv.find('\n') + 1;
+
+    WHEN( "it is split into 4 ranges after the header" ) {
+
+      auto splits = CSVTokenizer::splitRows(csv, from, 4);
+
+      THEN( "each split is the start of a row after the last" ) {
+
+        REQUIRE( splits.size() == 3 );
+        for (std::size_t i = 0; i < splits.size(); i++) {
+          REQUIRE( csv[splits[i] - 1] == '\n' );
+          REQUIRE( splits[i] > (i == 0 ? from : splits[i - 1]) );
+        }
+
+      } // THEN
+
+      THEN( "reading the ranges reads every row once and in order" ) {
+
+        std::vector<std::size_t> bounds = {from};
+        bounds.insert(bounds.end(), splits.begin(), splits.end());
+        bounds.push_back(csv.size());
+
+        std::vector<std::string> codes;
+        for (std::size_t i = 0; i + 1 < bounds.size(); i++) {
+          CSVTokenizer tokenizer(std::string_view(csv).substr(bounds[i], bounds[i + 1] - bounds[i]));
+          std::string_view field;
+          while (tokenizer.nextRow()) {
+            tokenizer.nextField(field);
+            codes.emplace_back(field);
+          }
+        }
+
+        REQUIRE( codes.size() == 1000 );
+        for (unsigned int area = 0; area < codes.size(); area++)
+          REQUIRE( codes[area] == DatasetGenerator::areaCode(area) );
+
+      } // THEN
+
+    } // WHEN
+
+    THEN( "a file is not split into more parts than it has rows" ) {
+
+      REQUIRE( CSVTokenizer::splitRows("code\na\nb\n", 5, 8).size() == 1 );
+      REQUIRE( CSVTokenizer::splitRows("code\na\n", 5, 8).empty() );
+      REQUIRE( CSVTokenizer::splitRows(csv, from, 1).empty() );
+      REQUIRE( CSVTokenizer::splitRows(csv, csv.size(), 4).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "rows with line breaks inside quoted fields" ) {
+
+    std::string csv = "code,name\n";
+    for (int row = 0; row < 100; row++)
+      csv += "a,\"line\n\"\"break\"\"\n\"\n";
+
+    THEN( "no split is inside a quoted field" ) {
+
+      auto splits = CSVTokenizer::splitRows(csv, 10, 7);
+      REQUIRE( splits.size() == 6 );
+      for (auto split : splits)
+        REQUIRE( csv.compare(split, 2, "a,") == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a large CSV file imported on several threads matches one thread", "[Areas][CSVTokenizer][threads]" ) {
+
+  struct Result {
+    std::string json;
+    std::string error;
+    ImportStats stats;
+  };
+
+  auto import = [](unsigned int threads,
+                   AreasStorage storage,
+                   const std::string &areasCSV,
+                   const std::string &contents,
+                   const StringFilterSet *areasFilter,
+                   const YearFilterTuple *yearsFilter) {
+    Areas areas;
+    areas.setStorage(storage);
+    areas.setThreads(threads);
+    Result result;
+    try {
+      areas.populate(std::string_view(areasCSV), BethYw::InputFiles::AREAS.PARSER, BethYw::InputFiles::AREAS.COLS,
+                     areasFilter, nullptr, nullptr);
+      if (!contents.empty())
+        areas.populate(std::string_view(contents), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                       BethYw::InputFiles::COMPLETE_POP.COLS, areasFilter, nullptr, yearsFilter);
+    } catch (const std::exception &ex) {
+      result.error = ex.what();
+    }
+    try {
+      result.json = areas.toJSON();
+    } catch (const std::exception &ex) {
+      result.json = ex.what();
+    }
+    result.stats = areas.getImportStats();
+    return result;
+  };
+
+  auto requireSame = [](const Result &parallel, const Result &sequential) {
+    REQUIRE( parallel.error == sequential.error );
+    REQUIRE( parallel.json == sequential.json );
+    REQUIRE( parallel.stats.rows == sequential.stats.rows );
+    REQUIRE( parallel.stats.areasAccepted == sequential.stats.areasAccepted );
+    REQUIRE( parallel.stats.measuresAccepted == sequential.stats.measuresAccepted );
+    REQUIRE( parallel.stats.readingsAccepted == sequential.stats.readingsAccepted );
+  };
+
+  GIVEN( "a generated areas file and AuthorityByYearCSV file of 80000 areas" ) {
+
+    DatasetGenerator generator(80000, 1, 20);
+    std::ostringstream areasOS;
+    generator.write(areasOS, BethYw::InputFiles::AREAS);
+    std::ostringstream popOS;
+    generator.write(popOS, BethYw::InputFiles::COMPLETE_POP);
+    const std::string areasCSV = areasOS.str();
+    const std::string popCSV = popOS.str();
+    REQUIRE( areasCSV.size() > 2 * 1024 * 1024 );
+    REQUIRE( popCSV.size() > 2 * 1024 * 1024 );
+
+    THEN( "the data and import counts are the same for both storages" ) {
+
+      for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+        Result parallel = import(4, storage, areasCSV, popCSV, nullptr, nullptr);
+        REQUIRE( parallel.error.empty() );
+        REQUIRE( parallel.stats.rows == 160000 );
+        requireSame(parallel, import(1, storage, areasCSV, popCSV, nullptr, nullptr));
+      }
+
+    } // THEN
+
+    THEN( "the data and import counts are the same with filters" ) {
+
+      StringFilterSet areasFilter({DatasetGenerator::areaCode(0), DatasetGenerator::areaCode(79999)});
+      YearFilterTuple yearsFilter = std::make_tuple(2005, 2010);
+      requireSame(import(4, AreasStorage::Objects, areasCSV, popCSV, &areasFilter, &yearsFilter),
+                  import(1, AreasStorage::Objects, areasCSV, popCSV, &areasFilter, &yearsFilter));
+
+    } // THEN
+
+    THEN( "an invalid value near the end gives the same error and data as one thread" ) {
+
+      std::string invalid = popCSV;
+      const std::size_t at = invalid.rfind(',') + 1;
+      invalid.replace(at, 1, "x");
+
+      Result parallel = import(4, AreasStorage::Objects, areasCSV, invalid, nullptr, nullptr);
+      REQUIRE_FALSE( parallel.error.empty() );
+      requireSame(parallel, import(1, AreasStorage::Objects, areasCSV, invalid, nullptr, nullptr));
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an AuthorityByYearCSV file with an invalid value in every range" ) {
+
+    DatasetGenerator generator(80000, 1, 20);
+    std::ostringstream areasOS;
+    generator.write(areasOS, BethYw::InputFiles::AREAS);
+    std::ostringstream popOS;
+    generator.write(popOS, BethYw::InputFiles::COMPLETE_POP);
+    const std::string areasCSV = areasOS.str();
+    std::string popCSV = popOS.str();
+
+    //one bad value in each eighth of the file, so every range throws
+    for (std::size_t part = 1; part <= 8; part++) {
+      const std::size_t at = popCSV.find(',', popCSV.size() * part / 9) + 1;
+      popCSV.replace(at, 1, "x");
+    }
+
+    THEN( "the error and the data are the same as on one thread for both storages" ) {
+
+      for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+        for (unsigned int threads : {2, 4, 8}) {
+          Result parallel = import(threads, storage, areasCSV, popCSV, nullptr, nullptr);
+          REQUIRE_FALSE( parallel.error.empty() );
+          requireSame(parallel, import(1, storage, areasCSV, popCSV, nullptr, nullptr));
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an areas file with line breaks and quotes inside its names" ) {
+
+    std::string areasCSV = "Local authority code,Name (eng),Name (cym)\n";
+    for (unsigned int area = 0; area < 60000; area++) {
+      const std::string number = std::to_string(area + 1);
+      areasCSV += DatasetGenerator::areaCode(area) + ",\"Area\n" + number + "\",\"Ardal \"\"" + number + "\"\"\"\n";
+    }
+    REQUIRE( areasCSV.size() > 2 * 1024 * 1024 );
+
+    THEN( "the names are the same as on one thread" ) {
+
+      Result parallel = import(4, AreasStorage::Objects, areasCSV, "", nullptr, nullptr);
+      REQUIRE( parallel.error.empty() );
+      REQUIRE( parallel.stats.rows == 60000 );
+      requireSame(parallel, import(1, AreasStorage::Objects, areasCSV, "", nullptr, nullptr));
+
+    } // THEN
+
+    THEN( "a quote inside an unquoted name does not change the names" ) {
+
+      //the quote throws out the count of quotes that splitRows() keeps, so
+      //every split is inside a quoted field
+      areasCSV.insert(areasCSV.find('\n') + 1, "W99000000,Area \"0,Ardal 0\n");
+      requireSame(import(4, AreasStorage::Objects, areasCSV, "", nullptr, nullptr),
+                  import(1, AreasStorage::Objects, areasCSV, "", nullptr, nullptr));
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,117 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../csv.h"
+
+SCENARIO( "a CSVBlockIndex finds the same characters as a search of every byte", "[CSVBlockIndex]" ) {
+
+  //the first position at or after from of a character of the given kinds
+  auto findEach = [](std::string_view text, std::size_t from, unsigned int kinds) {
+    for (std::size_t i = from; i < text.size(); i++) {
+      if (((kinds & CSVBlockIndex::COMMAS) && text[i] == ',') ||
+          ((kinds & CSVBlockIndex::QUOTES) && text[i] == '"') ||
+          ((kinds & CSVBlockIndex::NEWLINES) && (text[i] == '\n' || text[i] == '\r')))
+        return i;
+    }
+    return std::string_view::npos;
+  };
+
+  GIVEN( "pseudo-random text of many lengths" ) {
+
+    //mostly structural characters, with bytes above 0x7F to catch any
+    //signed comparisons
+    const std::string alphabet = ",\"\n\r,a1.\xC3\xB4 \xFF";
+    std::uint64_t state = 1;
+    std::string text;
+    for (unsigned int i = 0; i < 1000; i++) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      text += alphabet[(state >> 33) % alphabet.size()];
+    }
+
+    THEN( "every search from every position matches" ) {
+
+      for (std::size_t length : {0, 1, 63, 64, 65, 127, 128, 200, 1000}) {
+        std::string_view view(text.data(), length);
+        for (unsigned int kinds = 1; kinds < 8; kinds++) {
+          INFO( "length " << length << " kinds " << kinds );
+          CSVBlockIndex index(view);
+          for (std::size_t from = 0; from <= length; from++)
+            REQUIRE( index.find(from, kinds) == findEach(view, from, kinds) );
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "text with long runs between the structural characters" ) {
+
+    const std::string text = std::string(150, 'x') + "," + std::string(70, 'y') + "\"\n";
+    CSVBlockIndex index(text);
+
+    THEN( "searches skip whole blocks to find them" ) {
+
+      REQUIRE( index.find(0, CSVBlockIndex::COMMAS) == 150 );
+      REQUIRE( index.find(151, CSVBlockIndex::QUOTES) == 221 );
+      REQUIRE( index.find(151, CSVBlockIndex::NEWLINES) == 222 );
+      REQUIRE( index.find(223, CSVBlockIndex::COMMAS | CSVBlockIndex::QUOTES | CSVBlockIndex::NEWLINES) == std::string_view::npos );
+
+    } // THEN
+
+    THEN( "a search back into an earlier block still finds them" ) {
+
+      REQUIRE( index.find(200, CSVBlockIndex::NEWLINES) == 222 );
+      REQUIRE( index.find(0, CSVBlockIndex::COMMAS) == 150 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a CSVTokenizer splits fields that cross blocks of the index", "[CSVTokenizer][CSVBlockIndex]" ) {
+
+  GIVEN( "rows of long quoted and unquoted fields" ) {
+
+    const std::string longField(100, 'a');
+    const std::string csv = longField + ",\"" + longField + ",\n" + longField + "\"\"\"\r\n,x";
+
+    THEN( "the fields are the same as the text between the delimiters" ) {
+
+      CSVTokenizer tokenizer(csv);
+      std::string_view field;
+
+      REQUIRE( tokenizer.nextRow() );
+      REQUIRE( tokenizer.nextField(field) );
+      REQUIRE( field == longField );
+      REQUIRE( tokenizer.nextField(field) );
+      REQUIRE( field == longField + ",\n" + longField + "\"" );
+      REQUIRE_FALSE( tokenizer.nextField(field) );
+
+      REQUIRE( tokenizer.nextRow() );
+      REQUIRE( tokenizer.nextField(field) );
+      REQUIRE( field.empty() );
+      REQUIRE( tokenizer.nextField(field) );
+      REQUIRE( field == "x" );
+      REQUIRE_FALSE( tokenizer.nextRow() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,86 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../bethyw.h"
+#include "../input.h"
+
+SCENARIO( "dataset files can be read ahead of being opened", "[ReadAhead]" ) {
+
+  auto read_file = [](const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+  };
+
+  std::vector<std::string> paths;
+  for (unsigned int i = 0; i < BethYw::InputFiles::NUM_DATASETS; i++)
+    paths.push_back(std::string("datasets") + DIR_SEP + BethYw::InputFiles::DATASETS[i].FILE);
+
+  GIVEN( "a ReadAhead over every bundled dataset" ) {
+
+    ReadAhead readAhead(paths);
+
+    THEN( "each file can be opened while the next ones are read, and has the same bytes" ) {
+
+      for (std::size_t i = 0; i < paths.size(); i++) {
+        readAhead.opening(i);
+        MappedInputFile input(paths[i]);
+        REQUIRE( input.open() == read_file(paths[i]) );
+      }
+
+    } // THEN
+
+    THEN( "files can be opened out of order" ) {
+
+      readAhead.opening(paths.size() - 1);
+      readAhead.opening(0);
+      MappedInputFile input(paths[0]);
+      REQUIRE( input.open() == read_file(paths[0]) );
+
+    } // THEN
+
+    THEN( "it can be destroyed before any file is opened" ) {
+
+      SUCCEED();
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a ReadAhead over files that do not exist" ) {
+
+    ReadAhead readAhead({"datasets/missing1.csv", "datasets/missing2.json", paths[0]}, 1);
+
+    THEN( "they are skipped and the files after them can still be opened" ) {
+
+      for (std::size_t i = 0; i < 2; i++) {
+        readAhead.opening(i);
+        MappedInputFile input(i == 0 ? "datasets/missing1.csv" : "datasets/missing2.json");
+        REQUIRE_THROWS_AS( input.open(), std::runtime_error );
+      }
+      readAhead.opening(2);
+      MappedInputFile input(paths[0]);
+      REQUIRE( input.open() == read_file(paths[0]) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
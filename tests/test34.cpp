@@ -0,0 +1,166 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../measure.h"
+
+SCENARIO( "a Measure stores its readings in a run of years", "[Measure][run]" ) {
+
+  GIVEN( "a Measure with readings either side of a gap" ) {
+
+    Measure measure("pop", "Population");
+    measure.setValue(2000, 10);
+    measure.setValue(2010, 30);
+
+    THEN( "only the years that were set have readings" ) {
+
+      REQUIRE( measure.size() == 2 );
+      REQUIRE( measure.getValue(2000) == 10 );
+      REQUIRE( measure.getValue(2010) == 30 );
+      REQUIRE_THROWS_AS( measure.getValue(2005), std::out_of_range );
+      REQUIRE_THROWS_AS( measure.getValue(1999), std::out_of_range );
+      REQUIRE_THROWS_AS( measure.getValue(2011), std::out_of_range );
+
+    } // THEN
+
+    THEN( "the aggregates ignore the gap" ) {
+
+      REQUIRE( measure.getAverage() == 20 );
+      REQUIRE( measure.getDifference() == 20 );
+      REQUIRE( measure.getDifferenceAsPercentage() == 200 );
+
+    } // THEN
+
+    THEN( "a year in the gap can be filled in" ) {
+
+      measure.setValue(2005, 20);
+      REQUIRE( measure.size() == 3 );
+      REQUIRE( measure.getValue(2005) == 20 );
+      REQUIRE( measure.getAverage() == 20 );
+
+    } // THEN
+
+    THEN( "a year before the first year moves the start of the run" ) {
+
+      measure.setValue(1990, 5);
+      REQUIRE( measure.size() == 3 );
+      REQUIRE( measure.getValue(1990) == 5 );
+      REQUIRE( measure.getValue(2000) == 10 );
+      REQUIRE( measure.getValue(2010) == 30 );
+      REQUIRE( measure.getDifference() == 25 );
+
+    } // THEN
+
+    THEN( "a year too far from the others throws std::out_of_range and changes nothing" ) {
+
+      REQUIRE_THROWS_AS( measure.setValue(4000000000u, 1), std::out_of_range );
+      REQUIRE_THROWS_AS( measure.setValue(2010 - Measure::MAX_YEARS, 1), std::out_of_range );
+      REQUIRE( measure.size() == 2 );
+      REQUIRE( measure.getDifference() == 20 );
+
+      measure.setValue(2000 + Measure::MAX_YEARS - 1, 1);
+      REQUIRE( measure.size() == 3 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "two Measures whose runs of years do not overlap" ) {
+
+    Measure older("pop", "Population");
+    older.setValue(1990, 1);
+    older.setValue(1991, 2);
+    Measure newer("pop", "Population");
+    newer.setValue(2010, 3);
+    newer.setValue(2012, 4);
+
+    THEN( "merging either into the other gives every reading" ) {
+
+      Measure merged = older;
+      merged.merge(newer);
+      REQUIRE( merged.size() == 4 );
+      REQUIRE( merged.getValue(1990) == 1 );
+      REQUIRE( merged.getValue(2012) == 4 );
+      REQUIRE_THROWS_AS( merged.getValue(2000), std::out_of_range );
+      REQUIRE( merged.getDifference() == 3 );
+
+      Measure reversed = newer;
+      reversed.merge(older);
+      REQUIRE( reversed == merged );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Measures with the same readings set in different orders" ) {
+
+    Measure forwards("pop", "Population");
+    Measure backwards("pop", "Population");
+    for (unsigned int year = 2000; year <= 2010; year += 5)
+      forwards.setValue(year, year);
+    for (unsigned int year = 2010; year >= 2000; year -= 5)
+      backwards.setValue(year, year);
+
+    THEN( "they are equal" ) {
+
+      REQUIRE( forwards == backwards );
+      REQUIRE( backwards == forwards );
+
+    } // THEN
+
+    THEN( "they are not equal once one has a reading in a gap" ) {
+
+      backwards.setValue(2003, 2003);
+      REQUIRE_FALSE( forwards == backwards );
+      REQUIRE_FALSE( backwards == forwards );
+
+    } // THEN
+
+    THEN( "they are not equal with the same number of readings in other years" ) {
+
+      Measure shifted("pop", "Population");
+      for (unsigned int year = 2001; year <= 2011; year += 5)
+        shifted.setValue(year, year - 1);
+      REQUIRE_FALSE( forwards == shifted );
+      REQUIRE_FALSE( shifted == forwards );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an AuthorityByYearCSV file with a year far in the future is rejected", "[Areas][Measure][run]" ) {
+
+  GIVEN( "a header with the year 4000000000" ) {
+
+    const std::string csv = "AuthorityCode,2015,4000000000\nW06000011,1,2\n";
+
+    THEN( "std::invalid_argument is thrown before any reading is stored" ) {
+
+      Areas areas;
+      REQUIRE_THROWS_AS( areas.populate(std::string_view(csv), BethYw::InputFiles::COMPLETE_POP.PARSER,
+                                        BethYw::InputFiles::COMPLETE_POP.COLS),
+                         std::invalid_argument );
+      REQUIRE( areas.size() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
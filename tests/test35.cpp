@@ -0,0 +1,89 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 976789
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+
+SCENARIO( "the columns of a WelshStatsJSON file are resolved before its records are read", "[Areas][WelshStatsJSON]" ) {
+
+  const std::string path = std::string("datasets") + DIR_SEP + BethYw::InputFiles::TRAINS.FILE;
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string json = contents.str();
+  REQUIRE_FALSE( json.empty() );
+
+  //populate() itself rejects a mapping with too few columns, so these go
+  //straight to the WelshStatsJSON parser
+  GIVEN( "a column mapping without a year column" ) {
+
+    BethYw::SourceColumnMapping cols = BethYw::InputFiles::TRAINS.COLS;
+    cols.erase(BethYw::SourceColumn::YEAR);
+
+    THEN( "std::out_of_range is thrown in every mode and nothing is imported" ) {
+
+      for (auto mode : {WelshStatsJSONMode::Streaming, WelshStatsJSONMode::Document, WelshStatsJSONMode::Scanner}) {
+        Areas areas;
+        areas.setJSONMode(mode);
+        REQUIRE_THROWS_AS( areas.populateFromWelshStatsJSON(std::string_view(json), cols, nullptr, nullptr, nullptr),
+                           std::out_of_range );
+        REQUIRE( areas.size() == 0 );
+      }
+
+    } // THEN
+
+    THEN( "it is thrown even for a file with no records" ) {
+
+      for (auto mode : {WelshStatsJSONMode::Streaming, WelshStatsJSONMode::Document, WelshStatsJSONMode::Scanner}) {
+        Areas areas;
+        areas.setJSONMode(mode);
+        REQUIRE_THROWS_AS( areas.populateFromWelshStatsJSON(std::string_view("{\"value\":[]}"), cols, nullptr, nullptr, nullptr),
+                           std::out_of_range );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a dataset with a single measure and no measure columns" ) {
+
+    THEN( "it is imported in every mode and storage without an exception" ) {
+
+      for (auto mode : {WelshStatsJSONMode::Streaming, WelshStatsJSONMode::Document, WelshStatsJSONMode::Scanner}) {
+        for (auto storage : {AreasStorage::Objects, AreasStorage::Columns}) {
+          Areas areas;
+          areas.setJSONMode(mode);
+          areas.setStorage(storage);
+          REQUIRE_NOTHROW( areas.populate(std::string_view(json), BethYw::InputFiles::TRAINS.PARSER,
+                                          BethYw::InputFiles::TRAINS.COLS) );
+
+          Area &anglesey = areas.getArea("W06000001");
+          REQUIRE( anglesey.getName("eng") == "Isle of Anglesey" );
+          REQUIRE( anglesey.size() == 1 );
+          REQUIRE( anglesey.getMeasure("rail").getLabel() == "Rail passenger journeys" );
+          REQUIRE( anglesey.getMeasure("rail").getValue(2002) == 64405.5 );
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO